@@ -28,6 +28,7 @@ public:
 
 public:
     struct Data {
+        Application::Mode mode = Application::Mode::Gui;
         QScopedPointer<Console> console;
         QScopedPointer<PythonInterpreter> pythonInterpreter;
         QScopedPointer<Session> session;
@@ -45,11 +46,13 @@ void
 ApplicationPrivate::init()
 {
     d.console.reset(new Console());
-    d.console->start();
+    if (d.mode == Application::Mode::Gui)
+        d.console->start();
     d.session.reset(new Session());
     d.settings.reset(new Settings());
     d.style.reset(new Style());
-    d.pythonInterpreter.reset(new PythonInterpreter());  // after session
+    if (d.mode == Application::Mode::Gui)
+        d.pythonInterpreter.reset(new PythonInterpreter());  // after session
 #ifdef NDEBUG
     QStringList pluginDirs;
 
@@ -81,15 +84,22 @@ ApplicationPrivate::init()
 #endif
 }
 
-Application::Application(int& argc, char** argv)
+Application::Application(int& argc, char** argv, Mode mode)
     : QApplication(argc, argv)
     , p(new ApplicationPrivate())
 {
+    p->d.mode = mode;
     p->init();
 }
 
 Application::~Application() {}
 
+Application::Mode
+Application::mode() const
+{
+    return p->d.mode;
+}
+
 Console*
 Application::console() const
 {
@@ -99,6 +109,9 @@ Application::console() const
 PythonInterpreter*
 Application::pythonInterpreter() const
 {
+    // batch runs only pay for python when a script is run
+    if (!p->d.pythonInterpreter)
+        p->d.pythonInterpreter.reset(new PythonInterpreter());
     return p->d.pythonInterpreter.data();
 }
 
@@ -24,20 +24,38 @@ class ApplicationPrivate;
  */
 class Application : public QApplication {
     Q_OBJECT
+public:
+    /**
+     * @brief Application run mode.
+     */
+    enum Mode {
+        Gui,   ///< Interactive viewer with console capture.
+        Batch  ///< Headless batch processing, output goes to the terminal.
+    };
+
 public:
     /**
      * @brief Constructs the usdviewer application.
      *
+     * In Batch mode standard output is not captured by the console and
+     * the python interpreter is created on first use.
+     *
      * @param argc Argument count.
      * @param argv Argument vector.
+     * @param mode Application run mode.
      */
-    Application(int& argc, char** argv);
+    Application(int& argc, char** argv, Mode mode = Mode::Gui);
 
     /**
      * @brief Destroys the application.
      */
     ~Application() override;
 
+    /**
+     * @brief Returns the application run mode.
+     */
+    Mode mode() const;
+
     /** @name Subsystems */
     ///@{
 
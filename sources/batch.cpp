@@ -0,0 +1,404 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#include "batch.h"
+#include "application.h"
+#include "pythoninterpreter.h"
+#include "qtutils.h"
+#include "session.h"
+#include "stagegenerator.h"
+#include "tracelocks.h"
+#include "usdutils.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <pxr/usd/usdGeom/metrics.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace usdviewer {
+class BatchPrivate {
+public:
+    struct Options {
+        QString filename;
+        Session::LoadPolicy policy = Session::LoadPolicy::All;
+        Session::LoadOptions loadOptions;
+        bool stats = false;
+        QString json;
+        QString flatten;
+        QList<SdfPath> exportPaths;
+        QString output;
+        QString script;
+        QString generate;
+        StageGenerator::Options generator;
+
+        bool hasTasks() const { return stats || !flatten.isEmpty() || !exportPaths.isEmpty() || !script.isEmpty(); }
+    };
+
+    bool parse(const QStringList& arguments, Options& options);
+    bool parsePaths(const QString& value, QList<SdfPath>& paths);
+    template<typename T> bool parseNumber(const QString& argument, const QString& value, T& number);
+    bool generate(const Options& options);
+    bool runScript(const QString& filename);
+    bool writeStats(const Options& options, double loadSeconds);
+    void usage();
+    void error(const QString& message);
+
+public:
+    struct Data {
+        QTextStream out { stdout };
+        QTextStream err { stderr };
+    };
+    Data d;
+};
+
+bool
+BatchPrivate::parse(const QStringList& arguments, Options& options)
+{
+    for (int i = 1; i < arguments.size(); ++i) {
+        const QString& argument = arguments[i];
+        const bool hasValue = i + 1 < arguments.size();
+
+        if (argument == "--batch") {
+            continue;
+        }
+        else if (argument == "--help" || argument == "-h") {
+            return false;
+        }
+        else if (argument == "--stats") {
+            options.stats = true;
+        }
+        else if (!hasValue && argument.startsWith("--")) {
+            error(QString("Missing value for %1").arg(argument));
+            return false;
+        }
+        else if (argument == "--open") {
+            options.filename = arguments[++i];
+        }
+        else if (argument == "--policy") {
+            const QString policy = arguments[++i].toLower();
+            if (policy == "all")
+                options.policy = Session::LoadPolicy::All;
+            else if (policy == "none")
+                options.policy = Session::LoadPolicy::None;
+            else {
+                error(QString("Unknown load policy: %1").arg(policy));
+                return false;
+            }
+        }
+        else if (argument == "--mask") {
+            if (!parsePaths(arguments[++i], options.loadOptions.mask))
+                return false;
+        }
+        else if (argument == "--load-rules") {
+            options.loadOptions.loadRules = QFileInfo(arguments[++i]).absoluteFilePath();
+        }
+        else if (argument == "--json") {
+            options.json = arguments[++i];
+        }
+        else if (argument == "--flatten") {
+            options.flatten = arguments[++i];
+        }
+        else if (argument == "--export-selected") {
+            if (!parsePaths(arguments[++i], options.exportPaths))
+                return false;
+        }
+        else if (argument == "--output") {
+            options.output = arguments[++i];
+        }
+        else if (argument == "--script") {
+            options.script = arguments[++i];
+        }
+        else if (argument == "--generate") {
+            options.generate = arguments[++i];
+        }
+        else if (argument == "--prims") {
+            if (!parseNumber(argument, arguments[++i], options.generator.prims))
+                return false;
+        }
+        else if (argument == "--depth") {
+            if (!parseNumber(argument, arguments[++i], options.generator.depth))
+                return false;
+        }
+        else if (argument == "--fan-out") {
+            if (!parseNumber(argument, arguments[++i], options.generator.fanOut))
+                return false;
+        }
+        else if (argument == "--payload-density") {
+            if (!parseNumber(argument, arguments[++i], options.generator.payloadDensity))
+                return false;
+        }
+        else if (argument == "--instance-ratio") {
+            if (!parseNumber(argument, arguments[++i], options.generator.instanceRatio))
+                return false;
+        }
+        else if (argument == "--prototypes") {
+            if (!parseNumber(argument, arguments[++i], options.generator.prototypes))
+                return false;
+        }
+        else if (argument == "--variant-sets") {
+            if (!parseNumber(argument, arguments[++i], options.generator.variantSets))
+                return false;
+        }
+        else if (argument == "--variants") {
+            if (!parseNumber(argument, arguments[++i], options.generator.variants))
+                return false;
+        }
+        else if (argument == "--mesh-size") {
+            if (!parseNumber(argument, arguments[++i], options.generator.meshSize))
+                return false;
+        }
+        else if (argument == "--seed") {
+            if (!parseNumber(argument, arguments[++i], options.generator.seed))
+                return false;
+        }
+        else if (argument.startsWith("--")) {
+            error(QString("Unknown option: %1").arg(argument));
+            return false;
+        }
+        else if (options.filename.isEmpty()) {
+            options.filename = argument;
+        }
+        else {
+            error(QString("Unexpected argument: %1").arg(argument));
+            return false;
+        }
+    }
+
+    if (options.filename.isEmpty())
+        options.filename = options.generate;
+    if (options.filename.isEmpty()) {
+        error("No stage file given");
+        return false;
+    }
+    if (!options.exportPaths.isEmpty() && options.output.isEmpty()) {
+        error("--export-selected requires --output");
+        return false;
+    }
+    return true;
+}
+
+bool
+BatchPrivate::parsePaths(const QString& value, QList<SdfPath>& paths)
+{
+    const QStringList values = value.split(QRegularExpression("[,\\s]+"), Qt::SkipEmptyParts);
+    for (const QString& pathValue : values) {
+        const SdfPath path(QStringToString(pathValue));
+        if (!path.IsAbsolutePath() || !path.IsPrimPath()) {
+            error(QString("Invalid prim path: %1").arg(pathValue));
+            return false;
+        }
+        paths.append(path);
+    }
+    return true;
+}
+
+template<typename T>
+bool
+BatchPrivate::parseNumber(const QString& argument, const QString& value, T& number)
+{
+    bool ok = false;
+    const double parsed = value.toDouble(&ok);
+    // integer options reject fractions and values out of range rather than truncating them
+    if constexpr (std::is_integral_v<T>)
+        ok = ok && std::floor(parsed) == parsed && parsed <= static_cast<double>(std::numeric_limits<T>::max());
+    if (!ok || parsed < 0) {
+        error(QString("Invalid value for %1: %2").arg(argument, value));
+        return false;
+    }
+    number = static_cast<T>(parsed);
+    return true;
+}
+
+bool
+BatchPrivate::generate(const Options& options)
+{
+    QElapsedTimer timer;
+    timer.start();
+    StageGenerator generator(options.generator);
+    if (!generator.generate(options.generate)) {
+        error(generator.error());
+        return false;
+    }
+
+    const StageGenerator::Statistics statistics = generator.statistics();
+    d.err << QString("Generated %1 prims, %2 payloads, %3 instances in %4 s: %5")
+                 .arg(statistics.prims)
+                 .arg(statistics.payloads)
+                 .arg(statistics.instances)
+                 .arg(timer.elapsed() / 1000.0)
+                 .arg(options.generate)
+          << Qt::endl;
+    return true;
+}
+
+bool
+BatchPrivate::runScript(const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        error(QString("Failed to read script: %1").arg(filename));
+        return false;
+    }
+
+    bool failed = false;
+    const QMetaObject::Connection connection = QObject::connect(
+        session(), &Session::notifyStatusChanged, [&failed](Session::Notify::Status status) {
+            if (status == Session::Notify::Status::Error)
+                failed = true;
+        });
+
+    const QString output = pythonInterpreter()->executeScript(QString::fromUtf8(file.readAll()));
+    // failed lives on this stack frame, later notifications must not reach it
+    QObject::disconnect(connection);
+    if (!output.isEmpty())
+        d.out << output << Qt::endl;
+
+    if (failed)
+        error(QString("Script failed: %1").arg(filename));
+    return !failed;
+}
+
+bool
+BatchPrivate::writeStats(const Options& options, double loadSeconds)
+{
+    QJsonObject root;
+    {
+        READ_LOCKER(locker, session()->stageLock(), "stageLock");
+        const UsdStageRefPtr stage = session()->stageUnsafe();
+        if (!stage)
+            return false;
+
+        const stage::Statistics statistics = stage::statistics(stage);
+        QJsonObject prims;
+        prims["prims"] = qint64(statistics.prims);
+        prims["meshes"] = qint64(statistics.meshes);
+        prims["xforms"] = qint64(statistics.xforms);
+        prims["payloads"] = qint64(statistics.payloads);
+        prims["instances"] = qint64(statistics.instances);
+        prims["vertices"] = qint64(statistics.vertices);
+        prims["normals"] = qint64(statistics.normals);
+        prims["faces"] = qint64(statistics.faces);
+
+        root["file"] = session()->filename();
+        root["policy"] = options.policy == Session::LoadPolicy::All ? "all" : "none";
+        root["loadSeconds"] = loadSeconds;
+        root["layers"] = qint64(stage->GetUsedLayers(true).size());
+        root["upAxis"] = StringToQString(UsdGeomGetStageUpAxis(stage).GetString());
+        root["metersPerUnit"] = UsdGeomGetStageMetersPerUnit(stage);
+        root["statistics"] = prims;
+    }
+
+    const GfRange3d range = session()->boundingBox().ComputeAlignedRange();
+    if (!range.IsEmpty()) {
+        const GfVec3d min = range.GetMin();
+        const GfVec3d max = range.GetMax();
+        QJsonObject bounds;
+        bounds["min"] = QJsonArray { min[0], min[1], min[2] };
+        bounds["max"] = QJsonArray { max[0], max[1], max[2] };
+        root["bounds"] = bounds;
+    }
+
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    if (options.json.isEmpty()) {
+        d.out << QString::fromUtf8(json);
+        d.out.flush();
+        return true;
+    }
+
+    QFile file(options.json);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) == -1) {
+        error(QString("Failed to write statistics: %1").arg(options.json));
+        return false;
+    }
+    return true;
+}
+
+void
+BatchPrivate::usage()
+{
+    d.err << "usage: usdviewer --batch <file> [--policy all|none] [--mask <paths>] [--load-rules <file>]\n"
+             "                 [--script <file.py>] [--stats [--json <file>]] [--flatten <file>]\n"
+             "                 [--export-selected <paths> --output <file>]\n"
+             "       usdviewer --batch --generate <file> [--prims <n>] [--depth <n>] [--fan-out <n>]\n"
+             "                 [--payload-density <0-1>] [--instance-ratio <0-1>] [--prototypes <n>]\n"
+             "                 [--variant-sets <n>] [--variants <n>] [--mesh-size <n>] [--seed <n>]"
+          << Qt::endl;
+}
+
+void
+BatchPrivate::error(const QString& message)
+{
+    d.err << "usdviewer: " << message << Qt::endl;
+}
+
+Batch::Batch(QObject* parent)
+    : QObject(parent)
+    , p(new BatchPrivate())
+{}
+
+Batch::~Batch() = default;
+
+bool
+Batch::isBatch(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch") == 0)
+            return true;
+    }
+    return false;
+}
+
+int
+Batch::exec(const QStringList& arguments)
+{
+    BatchPrivate::Options options;
+    if (!p->parse(arguments, options)) {
+        p->usage();
+        return ExitCode::Usage;
+    }
+
+    if (!options.generate.isEmpty()) {
+        if (!p->generate(options))
+            return ExitCode::Failed;
+        if (!options.hasTasks())
+            return ExitCode::Success;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!session()->loadFromFile(options.filename, options.loadOptions, options.policy)) {
+        p->error(QString("Failed to load stage: %1").arg(options.filename));
+        return ExitCode::Failed;
+    }
+    const double loadSeconds = timer.elapsed() / 1000.0;
+
+    bool success = true;
+    if (!options.script.isEmpty())
+        success = p->runScript(options.script) && success;
+
+    if (options.stats)
+        success = p->writeStats(options, loadSeconds) && success;
+
+    if (!options.flatten.isEmpty() && !session()->flattenToFile(options.flatten)) {
+        p->error(QString("Failed to flatten stage: %1").arg(options.flatten));
+        success = false;
+    }
+
+    if (!options.exportPaths.isEmpty() && !session()->flattenPathsToFile(options.exportPaths, options.output)) {
+        p->error(QString("Failed to export paths: %1").arg(options.output));
+        success = false;
+    }
+
+    return success ? ExitCode::Success : ExitCode::Failed;
+}
+
+}  // namespace usdviewer
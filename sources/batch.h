@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#pragma once
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QStringList>
+
+namespace usdviewer {
+
+class BatchPrivate;
+
+/**
+ * @class Batch
+ * @brief Headless command line runner for session tasks.
+ *
+ * Runs session operations without a viewer window or OpenGL context,
+ * for use in render farm preflight jobs and continuous integration.
+ *
+ * Usage:
+ * @code
+ * usdviewer --batch file.usd [--policy all|none] [--mask <paths>] [--load-rules <file>]
+ *           [--script <file.py>] [--stats [--json <file>]] [--flatten <file>]
+ *           [--export-selected <paths> --output <file>]
+ * usdviewer --batch --generate file.usdc [--prims <n>] [--depth <n>] [--fan-out <n>] ...
+ * @endcode
+ *
+ * With --generate a synthetic stage is written by StageGenerator first
+ * and becomes the stage for the other tasks. The stage is loaded first,
+ * then the script is run, followed by statistics, flatten and export in
+ * that order, so they reflect any edits made by the script.
+ */
+class Batch : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @brief Exit codes returned by exec().
+     */
+    enum ExitCode {
+        Success = 0,  ///< All tasks succeeded.
+        Failed = 1,   ///< A task failed.
+        Usage = 2     ///< Invalid arguments.
+    };
+
+public:
+    /**
+     * @brief Constructs the batch runner.
+     *
+     * @param parent Optional parent object.
+     */
+    Batch(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroys the Batch instance.
+     */
+    ~Batch() override;
+
+    /**
+     * @brief Returns whether the command line requests batch mode.
+     */
+    static bool isBatch(int argc, char** argv);
+
+    /**
+     * @brief Runs the tasks given on the command line.
+     *
+     * @param arguments Application arguments.
+     * @return Process exit code.
+     */
+    int exec(const QStringList& arguments);
+
+private:
+    Q_DISABLE_COPY_MOVE(Batch)
+    QScopedPointer<BatchPrivate> p;
+};
+
+}  // namespace usdviewer
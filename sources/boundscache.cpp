@@ -0,0 +1,322 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#include "boundscache.h"
+#include "qtutils.h"
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <pxr/base/work/loops.h>
+#include <pxr/usd/usdGeom/bboxCache.h>
+#include <pxr/usd/usdGeom/boundable.h>
+#include <pxr/usd/usdGeom/imageable.h>
+#include <pxr/usd/usdGeom/modelAPI.h>
+#include <pxr/usd/usdGeom/tokens.h>
+#include <pxr/usd/usdGeom/xformable.h>
+#include <algorithm>
+#include <cmath>
+
+namespace usdviewer {
+class BoundsCachePrivate {
+public:
+    void applyInvalidations();
+    GfBBox3d bound(const UsdPrim& prim, int depth, UsdGeomBBoxCache& bboxCache);
+    bool isLeaf(const UsdPrim& prim, int depth) const;
+    bool isInvisible(const UsdPrim& prim) const;
+    QHash<SdfPath, GfBBox3d>& boundsFor(const SdfPath& path);
+    void reserveSelection(qsizetype count);
+    static std::vector<GfBBox3d> cluster(const std::vector<GfBBox3d>& bboxes, size_t maxCount);
+
+public:
+    struct Data {
+        int depth;
+        TfTokenVector purposes;
+        qsizetype capacity;
+        QHash<SdfPath, GfBBox3d> bounds;
+        QHash<SdfPath, GfBBox3d> selection;
+        QList<SdfPath> pending;
+        mutable QMutex mutex;
+        mutable QMutex pendingMutex;
+    };
+    Data d;
+};
+
+void
+BoundsCachePrivate::applyInvalidations()
+{
+    QList<SdfPath> paths;
+    {
+        QMutexLocker locker(&d.pendingMutex);
+        paths.swap(d.pending);
+    }
+
+    if (d.bounds.isEmpty() && d.selection.isEmpty())
+        return;
+
+    QSet<SdfPath> invalid;
+    for (const SdfPath& changed : paths) {
+        const SdfPath path = changed.IsPropertyPath() ? changed.GetPrimPath() : changed;
+        if (path.IsEmpty())
+            continue;
+
+        if (path.IsAbsoluteRootPath()) {
+            d.bounds.clear();
+            d.selection.clear();
+            return;
+        }
+        invalid.insert(path);
+    }
+
+    // world bounds of descendants depend on the transform of the path, one pass for all paths
+    const auto isInvalid = [&](const QHash<SdfPath, GfBBox3d>::iterator it) {
+        for (SdfPath prefix = it.key(); !prefix.IsEmpty(); prefix = prefix.GetParentPath()) {
+            if (invalid.contains(prefix))
+                return true;
+        }
+        return false;
+    };
+    d.bounds.removeIf(isInvalid);
+    d.selection.removeIf(isInvalid);
+
+    for (const SdfPath& path : invalid) {
+        for (SdfPath parent = path.GetParentPath(); !parent.IsEmpty(); parent = parent.GetParentPath()) {
+            d.bounds.remove(parent);
+            d.selection.remove(parent);
+        }
+    }
+}
+
+GfBBox3d
+BoundsCachePrivate::bound(const UsdPrim& prim, int depth, UsdGeomBBoxCache& bboxCache)
+{
+    const SdfPath path = prim.GetPath();
+    QHash<SdfPath, GfBBox3d>& bounds = boundsFor(path);
+    auto it = bounds.constFind(path);
+    if (it != bounds.constEnd())
+        return it.value();
+
+    GfBBox3d bbox;
+    if (isLeaf(prim, depth)) {
+        bbox = bboxCache.ComputeWorldBound(prim);
+    }
+    else if (!isInvisible(prim)) {
+        for (const UsdPrim& child : prim.GetChildren())
+            bbox = GfBBox3d::Combine(bbox, bound(child, depth + 1, bboxCache));
+    }
+
+    bounds.insert(path, bbox);
+    return bbox;
+}
+
+bool
+BoundsCachePrivate::isLeaf(const UsdPrim& prim, int depth) const
+{
+    if (depth >= d.depth || prim.IsInstance() || !prim.IsLoaded() || prim.IsA<UsdGeomBoundable>())
+        return true;
+
+    // UsdGeomBBoxCache prefers extentsHint over the children of models
+    const UsdGeomModelAPI modelApi(prim);
+    return prim.IsModel() && modelApi.GetExtentsHintAttr().HasAuthoredValue();
+}
+
+bool
+BoundsCachePrivate::isInvisible(const UsdPrim& prim) const
+{
+    const UsdGeomImageable imageable(prim);
+    if (!imageable)
+        return false;
+
+    TfToken visibility;
+    return imageable.GetVisibilityAttr().Get(&visibility) && visibility == UsdGeomTokens->invisible;
+}
+
+QHash<SdfPath, GfBBox3d>&
+BoundsCachePrivate::boundsFor(const SdfPath& path)
+{
+    // the upper levels are bounded by the hierarchy, prims below the cache depth only by what was selected
+    return static_cast<int>(path.GetPathElementCount()) > d.depth ? d.selection : d.bounds;
+}
+
+void
+BoundsCachePrivate::reserveSelection(qsizetype count)
+{
+    // dropped as a whole, the next selection is usually unrelated to the previous ones
+    if (d.selection.size() + count > d.capacity)
+        d.selection.clear();
+}
+
+std::vector<GfBBox3d>
+BoundsCachePrivate::cluster(const std::vector<GfBBox3d>& bboxes, size_t maxCount)
+{
+    std::vector<GfRange3d> ranges;
+    ranges.reserve(bboxes.size());
+    GfRange3d centers;
+    for (const GfBBox3d& bbox : bboxes) {
+        ranges.push_back(bbox.ComputeAlignedRange());
+        centers.UnionWith(ranges.back().GetMidpoint());
+    }
+
+    // bucket by center on a uniform grid of at most maxCount cells, each cell becomes one box
+    const int cells = std::max(1, static_cast<int>(std::cbrt(static_cast<double>(maxCount))));
+    const GfVec3d size = centers.GetSize();
+    QHash<qint64, GfRange3d> merged;
+    for (const GfRange3d& range : ranges) {
+        const GfVec3d midpoint = range.GetMidpoint();
+        qint64 key = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            int cell = 0;
+            if (size[axis] > 0.0)
+                cell = static_cast<int>((midpoint[axis] - centers.GetMin()[axis]) / size[axis] * cells);
+            key = key * cells + std::clamp(cell, 0, cells - 1);
+        }
+        merged[key].UnionWith(range);
+    }
+
+    std::vector<GfBBox3d> clusters;
+    clusters.reserve(merged.size());
+    for (const GfRange3d& range : merged)
+        clusters.emplace_back(range);
+    return clusters;
+}
+
+BoundsCache::BoundsCache(int depth, const TfTokenVector& purposes, qsizetype capacity)
+    : p(new BoundsCachePrivate())
+{
+    p->d.depth = std::max(1, depth);
+    p->d.purposes = purposes;
+    p->d.capacity = std::max<qsizetype>(1, capacity);
+}
+
+BoundsCache::~BoundsCache() = default;
+
+void
+BoundsCache::clear()
+{
+    invalidate({ SdfPath::AbsoluteRootPath() });
+}
+
+void
+BoundsCache::invalidate(const QList<SdfPath>& paths)
+{
+    QMutexLocker locker(&p->d.pendingMutex);
+    p->d.pending.append(paths);
+}
+
+QList<SdfPath>
+BoundsCache::changedPaths(const NoticeBatch& batch)
+{
+    QList<SdfPath> paths;
+    for (const NoticeEntry& entry : batch.entries) {
+        if (!entry.changedInfoOnly || entry.resolvedAssetPathsResynced) {
+            paths.append(entry.path);
+            continue;
+        }
+
+        if (!entry.path.IsPropertyPath()) {
+            paths.append(entry.path);
+            continue;
+        }
+
+        const TfToken name = entry.path.GetNameToken();
+        if (UsdGeomXformable::IsTransformationAffectedByAttrNamed(name) || name == UsdGeomTokens->extent
+            || name == UsdGeomTokens->extentsHint || name == UsdGeomTokens->visibility
+            || name == UsdGeomTokens->points) {
+            paths.append(entry.path);
+        }
+    }
+    return paths;
+}
+
+GfBBox3d
+BoundsCache::compute(const UsdStageRefPtr& stage)
+{
+    if (!stage)
+        return GfBBox3d();
+
+    QMutexLocker locker(&p->d.mutex);
+    p->applyInvalidations();
+
+    UsdGeomBBoxCache bboxCache(UsdTimeCode::Default(), p->d.purposes, true);
+    return p->bound(stage->GetPseudoRoot(), 0, bboxCache);
+}
+
+GfBBox3d
+BoundsCache::compute(const UsdStageRefPtr& stage, const QList<SdfPath>& paths)
+{
+    if (!stage)
+        return GfBBox3d();
+
+    QMutexLocker locker(&p->d.mutex);
+    p->applyInvalidations();
+
+    p->reserveSelection(paths.size());
+
+    UsdGeomBBoxCache bboxCache(UsdTimeCode::Default(), p->d.purposes, true);
+    GfBBox3d bbox;
+    for (const SdfPath& path : paths) {
+        const UsdPrim prim = stage->GetPrimAtPath(path);
+        if (!prim)
+            continue;
+
+        bbox = GfBBox3d::Combine(bbox, p->bound(prim, static_cast<int>(path.GetPathElementCount()), bboxCache));
+    }
+    return bbox;
+}
+
+std::vector<GfBBox3d>
+BoundsCache::computeEach(const UsdStageRefPtr& stage, const QList<SdfPath>& paths, size_t maxCount)
+{
+    std::vector<GfBBox3d> bboxes;
+    if (!stage)
+        return bboxes;
+
+    QMutexLocker locker(&p->d.mutex);
+    p->applyInvalidations();
+
+    std::vector<UsdPrim> prims;
+    std::vector<UsdPrim> misses;
+    prims.reserve(paths.size());
+    for (const SdfPath& path : paths) {
+        const UsdPrim prim = stage->GetPrimAtPath(path);
+        if (!prim)
+            continue;
+
+        prims.push_back(prim);
+        if (!p->boundsFor(path).contains(path) && p->isLeaf(prim, static_cast<int>(path.GetPathElementCount())))
+            misses.push_back(prim);
+    }
+    p->reserveSelection(static_cast<qsizetype>(misses.size()));
+
+    // subtree bounds are independent, UsdGeomBBoxCache is not shared between threads
+    std::vector<GfBBox3d> computed(misses.size());
+    WorkParallelForN(misses.size(), [&](size_t begin, size_t end) {
+        UsdGeomBBoxCache bboxCache(UsdTimeCode::Default(), p->d.purposes, true);
+        for (size_t i = begin; i < end; ++i)
+            computed[i] = bboxCache.ComputeWorldBound(misses[i]);
+    });
+    for (size_t i = 0; i < misses.size(); ++i)
+        p->boundsFor(misses[i].GetPath()).insert(misses[i].GetPath(), computed[i]);
+
+    // upper level prims combine cached child bounds
+    UsdGeomBBoxCache bboxCache(UsdTimeCode::Default(), p->d.purposes, true);
+    bboxes.reserve(prims.size());
+    for (const UsdPrim& prim : prims) {
+        const GfBBox3d bbox = p->bound(prim, static_cast<int>(prim.GetPath().GetPathElementCount()), bboxCache);
+        if (!bbox.GetRange().IsEmpty())
+            bboxes.push_back(bbox);
+    }
+
+    if (maxCount > 0 && bboxes.size() > maxCount)
+        return BoundsCachePrivate::cluster(bboxes, maxCount);
+    return bboxes;
+}
+
+qsizetype
+BoundsCache::size() const
+{
+    QMutexLocker locker(&p->d.mutex);
+    return p->d.bounds.size() + p->d.selection.size();
+}
+
+}  // namespace usdviewer
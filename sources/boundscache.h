@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#pragma once
+
+#include "notice.h"
+#include <QList>
+#include <QScopedPointer>
+#include <pxr/base/gf/bbox3d.h>
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usdGeom/imageable.h>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace usdviewer {
+
+class BoundsCachePrivate;
+
+/**
+ * @class BoundsCache
+ * @brief Persistent, incrementally invalidated world bounds cache.
+ *
+ * Caches world bounds for the upper levels of the prim hierarchy. Prims
+ * above the cache depth combine the bounds of their children, prims at
+ * the cache depth store the bound of their whole subtree. Invalidating a
+ * path drops the cached bounds of the path, its descendants and its
+ * ancestors, so only the affected branches are recomputed.
+ *
+ * Bounds of individual prims below the cache depth, such as a
+ * selection, are kept up to a capacity so they are reused between
+ * frames; missing ones are computed in parallel.
+ *
+ * All methods are thread-safe. Bounds are computed with extentsHint
+ * enabled and, by default, all purposes, matching Session::boundingBox().
+ */
+class BoundsCache {
+public:
+    /**
+     * @brief Constructs an empty bounds cache.
+     *
+     * @param depth Hierarchy depth of cached subtree bounds.
+     * @param purposes Purposes included in the bounds.
+     * @param capacity Maximum number of cached bounds below the cache depth.
+     */
+    BoundsCache(int depth = 4, const TfTokenVector& purposes = UsdGeomImageable::GetOrderedPurposeTokens(),
+                qsizetype capacity = 65536);
+
+    /**
+     * @brief Destroys the BoundsCache instance.
+     */
+    ~BoundsCache();
+
+    /**
+     * @brief Removes all cached bounds.
+     */
+    void clear();
+
+    /**
+     * @brief Invalidates cached bounds affected by changes to paths.
+     *
+     * Invalidations are queued and applied by the next compute(), so this
+     * never waits for a computation running on another thread. Property
+     * paths invalidate their owning prim.
+     *
+     * @param paths Changed prim or property paths.
+     */
+    void invalidate(const QList<SdfPath>& paths);
+
+    /**
+     * @brief Returns the paths of a notice batch that affect bounds.
+     *
+     * Resyncs and changes to transforms, extents, visibility and points.
+     */
+    static QList<SdfPath> changedPaths(const NoticeBatch& batch);
+
+    /**
+     * @brief Returns the world bound of the stage.
+     *
+     * Recomputes invalidated branches only.
+     */
+    GfBBox3d compute(const UsdStageRefPtr& stage);
+
+    /**
+     * @brief Returns the combined world bound of prim paths.
+     */
+    GfBBox3d compute(const UsdStageRefPtr& stage, const QList<SdfPath>& paths);
+
+    /**
+     * @brief Returns the world bound of each prim path.
+     *
+     * Empty bounds are skipped. When more than @p maxCount bounds remain
+     * they are merged by location into at most @p maxCount clusters.
+     *
+     * @param stage USD stage to query.
+     * @param paths Prim paths.
+     * @param maxCount Maximum number of returned bounds, 0 for no limit.
+     */
+    std::vector<GfBBox3d> computeEach(const UsdStageRefPtr& stage, const QList<SdfPath>& paths, size_t maxCount = 0);
+
+    /**
+     * @brief Returns the number of cached bounds.
+     */
+    qsizetype size() const;
+
+private:
+    Q_DISABLE_COPY_MOVE(BoundsCache)
+    QScopedPointer<BoundsCachePrivate> p;
+};
+
+}  // namespace usdviewer
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#include "hierarchycache.h"
+#include "subtreecache.h"
+#include "usdutils.h"
+#include <QPointer>
+#include <algorithm>
+
+namespace usdviewer {
+class HierarchyCachePrivate {
+public:
+    struct Policy {
+        struct Entry {
+            int depth = 0;
+            int maxDepth = 0;
+        };
+        Entry compute(const UsdPrim& prim) { return empty(prim.GetPath()); }
+        bool isExpanded(const UsdPrim& prim) const;
+        static void add(Entry& entry, const Entry& child) { entry.maxDepth = std::max(entry.maxDepth, child.maxDepth); }
+        static bool isEmpty(const Entry& entry) { return entry.maxDepth == entry.depth; }
+        static Entry empty(const SdfPath& path);
+
+        UsdStageRefPtr stage;
+        bool payloadBoundaries = false;
+    };
+
+    void init();
+
+public:
+    struct Data {
+        SubtreeCache<Policy> subtrees;  // prims with children only
+        QPointer<HierarchyCache> cache;
+    };
+    Data d;
+};
+
+bool
+HierarchyCachePrivate::Policy::isExpanded(const UsdPrim& prim) const
+{
+    return !payloadBoundaries || prim.IsPseudoRoot() || !stage::isPayload(stage, prim.GetPath());
+}
+
+HierarchyCachePrivate::Policy::Entry
+HierarchyCachePrivate::Policy::empty(const SdfPath& path)
+{
+    const int depth = int(path.GetPathElementCount());
+    return Entry { depth, depth };
+}
+
+void
+HierarchyCachePrivate::init()
+{
+    QPointer<HierarchyCache> cache = d.cache;
+    d.subtrees.setNotify([cache]() {
+        if (!cache)
+            return;
+
+        QMetaObject::invokeMethod(
+            cache,
+            [cache]() {
+                if (cache)
+                    Q_EMIT cache->changed();
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+HierarchyCache::HierarchyCache(QObject* parent)
+    : QObject(parent)
+    , p(new HierarchyCachePrivate())
+{
+    p->d.cache = this;
+    p->init();
+}
+
+HierarchyCache::~HierarchyCache() = default;
+
+void
+HierarchyCache::setStage(UsdStageRefPtr stage, QReadWriteLock* lock, bool payloadBoundaries)
+{
+    HierarchyCachePrivate::Policy policy;
+    policy.stage = stage;
+    policy.payloadBoundaries = payloadBoundaries;
+    p->d.subtrees.setStage(stage, lock, policy);
+}
+
+void
+HierarchyCache::invalidate(const QList<SdfPath>& paths)
+{
+    p->d.subtrees.invalidate(paths);
+}
+
+bool
+HierarchyCache::isReady() const
+{
+    return p->d.subtrees.isReady();
+}
+
+int
+HierarchyCache::maxDepth(const SdfPath& path) const
+{
+    return p->d.subtrees.entry(path.IsEmpty() ? SdfPath::AbsoluteRootPath() : path).maxDepth;
+}
+
+}  // namespace usdviewer
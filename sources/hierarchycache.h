@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QScopedPointer>
+#include <pxr/usd/usd/stage.h>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace usdviewer {
+
+class HierarchyCachePrivate;
+
+/**
+ * @class HierarchyCache
+ * @brief Precomputed subtree depth of a stage.
+ *
+ * Stores, for every prim with children, the deepest path element count
+ * reached below it. The table is a SubtreeCache, built in parallel on a
+ * worker thread when the stage is set, and resynced paths passed to
+ * invalidate() are recomputed in the background together with their
+ * ancestors, so lookups never traverse the stage. Descendant counts are
+ * provided by StatisticsCache.
+ *
+ * When payload boundaries are enabled, prims with payloads count as
+ * leaves, matching the outliner where payload prims are not expanded.
+ *
+ * Lookups are thread-safe, other methods must be called from the GUI
+ * thread.
+ */
+class HierarchyCache : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @brief Constructs an empty cache.
+     *
+     * @param parent Optional parent object.
+     */
+    HierarchyCache(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroys the HierarchyCache instance.
+     */
+    ~HierarchyCache() override;
+
+    /**
+     * @brief Sets the stage to describe and starts building the table.
+     *
+     * @param stage Stage, or null to clear the cache.
+     * @param lock Lock guarding the stage.
+     * @param payloadBoundaries Treat payload prims as leaves.
+     */
+    void setStage(UsdStageRefPtr stage, QReadWriteLock* lock, bool payloadBoundaries);
+
+    /**
+     * @brief Recomputes the subtrees of resynced prim paths.
+     *
+     * Updates are queued and applied on a worker thread.
+     */
+    void invalidate(const QList<SdfPath>& paths);
+
+    /**
+     * @brief Returns true once the table for the current stage is built.
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Returns the deepest path element count at or below @p path.
+     *
+     * Leaves return their own depth.
+     */
+    int maxDepth(const SdfPath& path) const;
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted when the table has been built or updated.
+     */
+    void changed();
+
+private:
+    Q_DISABLE_COPY_MOVE(HierarchyCache)
+    QScopedPointer<HierarchyCachePrivate> p;
+};
+
+}  // namespace usdviewer
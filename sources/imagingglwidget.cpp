@@ -4,11 +4,13 @@
 
 #include "imagingglwidget.h"
 #include "application.h"
+#include "boundscache.h"
 #include "command.h"
 #include "notice.h"
 #include "os.h"
 #include "qtutils.h"
 #include "signalguard.h"
+#include "statisticscache.h"
 #include "style.h"
 #include "tracelocks.h"
 #include "usdutils.h"
@@ -35,9 +37,9 @@
 #include <pxr/imaging/hd/renderIndex.h>
 #include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/usd/stage.h>
-#include <pxr/usd/usdGeom/bboxCache.h>
 #include <pxr/usd/usdGeom/camera.h>
 #include <pxr/usd/usdGeom/metrics.h>
+#include <pxr/usd/usdGeom/tokens.h>
 #include <pxr/usd/usdGeom/xform.h>
 #include <pxr/usdImaging/usdImaging/delegate.h>
 #include <pxr/usdImaging/usdImagingGL/engine.h>
@@ -71,6 +73,7 @@ public:
     void captureVisible();
     void clearVisibleCapture();
     void rebuildSelectionBBoxes();
+    void setStatistics(StatisticsCache* statistics);
 
 public:
     QPoint deviceRatio(QPoint value) const;
@@ -129,6 +132,8 @@ public:
         QList<SdfPath> selection;
         QList<SdfPath> visibleCapture;
         std::vector<GfBBox3d> selectionBBoxes;
+        QScopedPointer<BoundsCache> selectionBounds;
+        QPointer<StatisticsCache> statistics;
         QScopedPointer<UsdImagingGLEngine> glEngine;
         QPointer<ViewContext> context;
         QPointer<ImagingGLWidget> glwidget;
@@ -164,6 +169,8 @@ ImagingGLWidgetPrivate::init()
     d.sweep = false;
     d.drawMode = ImagingGLWidget::DrawMode::ShadedSmooth;
     d.context = nullptr;
+    d.selectionBounds.reset(
+        new BoundsCache(4, { UsdGeomTokens->default_, UsdGeomTokens->proxy, UsdGeomTokens->render }));
 }
 
 void
@@ -224,20 +231,33 @@ ImagingGLWidgetPrivate::rebuildSelectionBBoxes()
     if (!d.stage)
         return;
 
-    UsdGeomBBoxCache bboxCache(UsdTimeCode::Default(),
-                               { UsdGeomTokens->default_, UsdGeomTokens->proxy, UsdGeomTokens->render }, true);
-
-    d.selectionBBoxes.reserve(d.selection.size());
+    // bounds persist between selections, beyond the limit nearby boxes are drawn as one
+    const size_t maxSelectionBBoxes = 4096;
+    d.selectionBBoxes = d.selectionBounds->computeEach(d.stage, d.selection, maxSelectionBBoxes);
+}
 
-    for (const SdfPath& path : d.selection) {
-        UsdPrim prim = d.stage->GetPrimAtPath(path);
-        if (!prim)
-            continue;
+void
+ImagingGLWidgetPrivate::setStatistics(StatisticsCache* statistics)
+{
+    if (d.statistics == statistics)
+        return;
 
-        GfBBox3d bbox = bboxCache.ComputeWorldBound(prim);
-        if (!bbox.GetRange().IsEmpty())
-            d.selectionBBoxes.push_back(bbox);
+    if (d.statistics) {
+        d.statistics->setEnabled(d.glwidget, false);
+        disconnect(d.statistics, nullptr, this, nullptr);
     }
+    d.statistics = statistics;
+    if (!d.statistics)
+        return;
+
+    // statistics are kept only while the overlay is shown
+    d.statistics->setEnabled(d.glwidget, d.sceneTreeEnabled);
+    connect(d.statistics, &StatisticsCache::changed, this, [this]() {
+        if (!d.sceneTreeEnabled)
+            return;
+        updateSceneTree();
+        d.glwidget->update();
+    });
 }
 
 void
@@ -253,6 +273,7 @@ ImagingGLWidgetPrivate::close()
     d.viewCamera = ViewCamera();
     d.drag = false;
     d.sweep = false;
+    d.selectionBounds->clear();
 
     d.glEngine.reset();
     initGL();
@@ -893,6 +914,7 @@ ImagingGLWidgetPrivate::updateStage(UsdStageRefPtr stage)
     d.visibleCapture.clear();
     d.selectionBBoxes.clear();
     d.glEngine.reset();
+    d.selectionBounds->clear();
     initGL();
     if (d.stage)
         initCamera();
@@ -922,9 +944,8 @@ ImagingGLWidgetPrivate::updateMask(const QList<SdfPath>& paths)
 void
 ImagingGLWidgetPrivate::updatePrims(const NoticeBatch& batch)
 {
-    Q_UNUSED(batch);
-
     SignalGuard::Scope guard(this);
+    d.selectionBounds->invalidate(BoundsCache::changedPaths(batch));
     rebuildSelectionBBoxes();
     if (d.sceneTreeEnabled) {
         updateSceneTree();
@@ -1060,106 +1081,23 @@ ImagingGLWidgetPrivate::drawAxis(QPainter& painter)
 void
 ImagingGLWidgetPrivate::updateSceneTree()
 {
-    struct SceneStats {
-        size_t prims = 0;
-        size_t meshes = 0;
-        size_t xforms = 0;
-        size_t payloads = 0;
-        size_t instances = 0;
-        size_t vertices = 0;
-        size_t normals = 0;
-        size_t faces = 0;
-    };
-
-    auto accumulate = [&](const UsdPrim& prim, SceneStats& s) {
-        if (!prim.IsActive() || !prim.IsLoaded())
-            return;
-
-        s.prims++;
-
-        if (prim.IsA<UsdGeomXform>())
-            s.xforms++;
-
-        if (prim.IsA<UsdGeomMesh>()) {
-            s.meshes++;
-            UsdGeomMesh mesh(prim);
-
-            VtArray<GfVec3f> points;
-            mesh.GetPointsAttr().Get(&points);
-            s.vertices += points.size();
-
-            VtArray<int> faceCounts;
-            mesh.GetFaceVertexCountsAttr().Get(&faceCounts);
-            s.faces += faceCounts.size();
-
-            VtArray<GfVec3f> meshNormals;
-            UsdGeomPrimvarsAPI pvAPI(prim);
-            UsdGeomPrimvar normalsPv = pvAPI.GetPrimvar(TfToken("normals"));
-
-            bool hasNormals = false;
-            if (normalsPv && normalsPv.HasValue()) {
-                normalsPv.Get(&meshNormals);
-                hasNormals = true;
-            }
-            if (!hasNormals) {
-                mesh.GetNormalsAttr().Get(&meshNormals);
-            }
-
-            s.normals += meshNormals.size();
-        }
-
-        if (prim.HasPayload())
-            s.payloads++;
-
-        if (prim.IsInstanceable())
-            s.instances++;
-    };
-
-    auto filterRootPaths = [](const QList<SdfPath>& paths) {
-        QList<SdfPath> result;
-        for (const SdfPath& p : paths) {
-            bool isChild = false;
-            for (const SdfPath& other : paths) {
-                if (p == other)
-                    continue;
-                if (p.HasPrefix(other)) {
-                    isChild = true;
-                    break;
-                }
-            }
-            if (!isChild)
-                result.append(p);
-        }
-        return result;
-    };
-
-    SceneStats total;
-    SceneStats selected;
-    if (d.stage) {
-        READ_LOCKER(locker, d.context->stageLock(), "stageLock");
-        for (const UsdPrim& prim : d.stage->Traverse()) {
-            accumulate(prim, total);
-        }
-        if (!d.selection.isEmpty()) {
-            const QList<SdfPath> roots = filterRootPaths(d.selection);
-
-            for (const SdfPath& path : roots) {
-                UsdPrim root = d.stage->GetPrimAtPath(path);
-                if (!root)
-                    continue;
-
-                for (const UsdPrim& prim : UsdPrimRange(root)) {
-                    accumulate(prim, selected);
-                }
-            }
-        }
+    // totals are cache lookups, values show as pending until the worker has finished
+    StatisticsCache::Entry total;
+    StatisticsCache::Entry selected;
+    const bool pending = d.stage && d.statistics && !d.statistics->isReady();
+    if (d.stage && d.statistics && !pending) {
+        total = d.statistics->entry(SdfPath::AbsoluteRootPath());
+        if (!d.selection.isEmpty())
+            selected = d.statistics->total(d.selection);
     }
 
     QLocale locale = QLocale::system();
-    auto fmt = [&](size_t v) { return locale.toString((qlonglong)v); };
+    auto fmt = [&](qint64 v) { return locale.toString(v); };
 
     const bool hasSelection = !d.selection.isEmpty();
-    auto fmtPair = [&](size_t totalValue, size_t selectedValue) {
+    auto fmtPair = [&](qint64 totalValue, qint64 selectedValue) {
+        if (pending)
+            return QString("...");
         if (hasSelection && selectedValue > 0)
             return QString("%1 (%2)").arg(fmt(totalValue), fmt(selectedValue));
         return fmt(totalValue);
@@ -1336,6 +1274,7 @@ ImagingGLWidget::setContext(ViewContext* context)
 {
     if (p->d.context != context) {
         p->d.context = context;
+        p->setStatistics(context ? context->statisticsCache() : nullptr);
     }
 }
 
@@ -1455,6 +1394,8 @@ ImagingGLWidget::enableSceneTree(bool enabled)
 {
     if (enabled != p->d.sceneTreeEnabled) {
         p->d.sceneTreeEnabled = enabled;
+        if (p->d.statistics)
+            p->d.statistics->setEnabled(this, enabled);
         p->updateSceneTree();
         update();
     }
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#include "layerwatcher.h"
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QPointer>
+#include <QSet>
+#include <QTimer>
+
+namespace usdviewer {
+class LayerWatcherPrivate : public QObject {
+public:
+    void init();
+    void fileChanged(const QString& file);
+    void rewatch();
+    void flush();
+
+public:
+    struct Data {
+        QSet<QString> files;
+        QSet<QString> changed;
+        QFileSystemWatcher watcher;
+        QTimer timer;
+        QPointer<LayerWatcher> layerWatcher;
+    };
+    Data d;
+};
+
+void
+LayerWatcherPrivate::init()
+{
+    d.timer.setSingleShot(true);
+    d.timer.setInterval(500);
+    connect(&d.watcher, &QFileSystemWatcher::fileChanged, this, &LayerWatcherPrivate::fileChanged);
+    connect(&d.timer, &QTimer::timeout, this, &LayerWatcherPrivate::flush);
+}
+
+void
+LayerWatcherPrivate::fileChanged(const QString& file)
+{
+    if (!d.files.contains(file))
+        return;
+
+    d.changed.insert(file);
+    d.timer.start();
+}
+
+void
+LayerWatcherPrivate::rewatch()
+{
+    // editors often save by writing a temporary file and renaming it over
+    // the original, which removes the file from the watcher
+    const QStringList watched = d.watcher.files();
+    const QSet<QString> current(watched.begin(), watched.end());
+    QStringList missing;
+    for (const QString& file : d.files) {
+        if (!current.contains(file) && QFileInfo::exists(file))
+            missing.append(file);
+    }
+    if (!missing.isEmpty())
+        d.watcher.addPaths(missing);
+}
+
+void
+LayerWatcherPrivate::flush()
+{
+    rewatch();
+    if (d.changed.isEmpty())
+        return;
+
+    QStringList files(d.changed.begin(), d.changed.end());
+    files.sort();
+    d.changed.clear();
+    Q_EMIT d.layerWatcher->filesChanged(files);
+}
+
+LayerWatcher::LayerWatcher(QObject* parent)
+    : QObject(parent)
+    , p(new LayerWatcherPrivate())
+{
+    p->d.layerWatcher = this;
+    p->init();
+}
+
+LayerWatcher::~LayerWatcher() = default;
+
+int
+LayerWatcher::debounce() const
+{
+    return p->d.timer.interval();
+}
+
+void
+LayerWatcher::setDebounce(int msecs)
+{
+    p->d.timer.setInterval(qMax(0, msecs));
+}
+
+QStringList
+LayerWatcher::files() const
+{
+    QStringList files(p->d.files.begin(), p->d.files.end());
+    files.sort();
+    return files;
+}
+
+void
+LayerWatcher::setFiles(const QStringList& files)
+{
+    const QSet<QString> next(files.begin(), files.end());
+    if (next == p->d.files)
+        return;
+
+    QStringList removed;
+    for (const QString& file : p->d.files) {
+        if (!next.contains(file))
+            removed.append(file);
+    }
+    if (!removed.isEmpty())
+        p->d.watcher.removePaths(removed);
+
+    for (const QString& file : removed)
+        p->d.changed.remove(file);
+
+    p->d.files = next;
+    p->rewatch();
+}
+
+void
+LayerWatcher::clear()
+{
+    const QStringList watched = p->d.watcher.files();
+    if (!watched.isEmpty())
+        p->d.watcher.removePaths(watched);
+
+    p->d.files.clear();
+    p->d.changed.clear();
+    p->d.timer.stop();
+}
+
+}  // namespace usdviewer
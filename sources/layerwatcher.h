@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#pragma once
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QStringList>
+
+namespace usdviewer {
+
+class LayerWatcherPrivate;
+
+/**
+ * @class LayerWatcher
+ * @brief Debounced file watcher for layer files.
+ *
+ * Watches a set of layer files on disk and reports changes in
+ * debounced groups, so a single save that touches a file several
+ * times, or replaces it through a rename, is reported once. Files
+ * replaced on disk are watched again as soon as they reappear.
+ */
+class LayerWatcher : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @brief Constructs the layer watcher.
+     *
+     * @param parent Optional parent object.
+     */
+    LayerWatcher(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroys the LayerWatcher instance.
+     */
+    ~LayerWatcher() override;
+
+    /**
+     * @brief Returns the debounce interval in milliseconds.
+     */
+    int debounce() const;
+
+    /**
+     * @brief Sets the debounce interval in milliseconds.
+     */
+    void setDebounce(int msecs);
+
+    /**
+     * @brief Returns the watched files.
+     */
+    QStringList files() const;
+
+    /**
+     * @brief Replaces the set of watched files.
+     */
+    void setFiles(const QStringList& files);
+
+    /**
+     * @brief Stops watching all files and drops pending changes.
+     */
+    void clear();
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted once per debounce interval with the changed files.
+     */
+    void filesChanged(const QStringList& files);
+
+private:
+    Q_DISABLE_COPY_MOVE(LayerWatcher)
+    QScopedPointer<LayerWatcherPrivate> p;
+};
+
+}  // namespace usdviewer
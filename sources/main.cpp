@@ -3,11 +3,19 @@
 // https://github.com/mikaelsundell/usdviewer
 
 #include "application.h"
+#include "batch.h"
 #include "viewer.h"
 
 int
 main(int argc, char* argv[])
 {
+    if (usdviewer::Batch::isBatch(argc, argv)) {
+        // no display is needed, the offscreen platform keeps Qt Gui usable headless
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+        usdviewer::Application app(argc, argv, usdviewer::Application::Mode::Batch);
+        usdviewer::Batch batch;
+        return batch.exec(QCoreApplication::arguments());
+    }
     usdviewer::Application app(argc, argv);
     usdviewer::Viewer viewer;
     viewer.setArguments(QCoreApplication::arguments());
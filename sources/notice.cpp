@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#include "notice.h"
+#include "qtutils.h"
+#include <QHash>
+#include <QSet>
+#include <algorithm>
+
+namespace usdviewer {
+class NoticeCoalescerPrivate {
+public:
+    enum Kind { InfoOnly, AssetResync, Resync, NamespaceEdit };
+
+    static Kind kind(const NoticeEntry& entry);
+    bool isCovered(const SdfPath& path, bool inclusive, const QSet<SdfPath>& resynced) const;
+    void append(const NoticeEntry& entry);
+
+public:
+    struct Slots {
+        qsizetype infoOnly = -1;
+        qsizetype assetResync = -1;
+        qsizetype resync = -1;
+    };
+    struct Data {
+        QList<NoticeEntry> entries;
+        QHash<SdfPath, Slots> slots;
+    };
+    Data d;
+};
+
+NoticeCoalescerPrivate::Kind
+NoticeCoalescerPrivate::kind(const NoticeEntry& entry)
+{
+    if (entry.changedInfoOnly)
+        return InfoOnly;
+    if (entry.resolvedAssetPathsResynced)
+        return AssetResync;
+
+    switch (entry.primResyncType) {
+    case UsdNotice::ObjectsChanged::PrimResyncType::RenameSource:
+    case UsdNotice::ObjectsChanged::PrimResyncType::RenameDestination:
+    case UsdNotice::ObjectsChanged::PrimResyncType::ReparentSource:
+    case UsdNotice::ObjectsChanged::PrimResyncType::ReparentDestination:
+    case UsdNotice::ObjectsChanged::PrimResyncType::RenameAndReparentSource:
+    case UsdNotice::ObjectsChanged::PrimResyncType::RenameAndReparentDestination: return NamespaceEdit;
+    default: break;
+    }
+    return Resync;
+}
+
+bool
+NoticeCoalescerPrivate::isCovered(const SdfPath& path, bool inclusive, const QSet<SdfPath>& resynced) const
+{
+    for (SdfPath parent = inclusive ? path : path.GetParentPath(); !parent.IsEmpty(); parent = parent.GetParentPath()) {
+        if (resynced.contains(parent))
+            return true;
+    }
+    return false;
+}
+
+void
+NoticeCoalescerPrivate::append(const NoticeEntry& entry)
+{
+    const Kind entryKind = kind(entry);
+    if (entryKind == NamespaceEdit) {
+        // later entries must not merge into slots from before the edit, they refer to other prims
+        d.entries.append(entry);
+        d.slots.clear();
+        return;
+    }
+
+    Slots& slot = d.slots[entry.path];
+    qsizetype& index = (entryKind == InfoOnly) ? slot.infoOnly
+                       : (entryKind == AssetResync) ? slot.assetResync
+                                                    : slot.resync;
+    if (index < 0) {
+        index = d.entries.size();
+        d.entries.append(entry);
+        return;
+    }
+
+    NoticeEntry& existing = d.entries[index];
+    if (entryKind == InfoOnly) {
+        for (const TfToken& field : entry.changedFields) {
+            if (std::find(existing.changedFields.begin(), existing.changedFields.end(), field)
+                == existing.changedFields.end())
+                existing.changedFields.push_back(field);
+        }
+    }
+    else if (entryKind == Resync && existing.primResyncType != entry.primResyncType) {
+        existing.primResyncType = UsdNotice::ObjectsChanged::PrimResyncType::Other;
+    }
+}
+
+NoticeCoalescer::NoticeCoalescer()
+    : p(new NoticeCoalescerPrivate())
+{}
+
+NoticeCoalescer::~NoticeCoalescer() = default;
+
+void
+NoticeCoalescer::append(const NoticeBatch& batch)
+{
+    for (const NoticeEntry& entry : batch.entries)
+        p->append(entry);
+}
+
+bool
+NoticeCoalescer::isEmpty() const
+{
+    return p->d.entries.isEmpty();
+}
+
+qsizetype
+NoticeCoalescer::size() const
+{
+    return p->d.entries.size();
+}
+
+void
+NoticeCoalescer::clear()
+{
+    p->d.entries.clear();
+    p->d.slots.clear();
+}
+
+NoticeBatch
+NoticeCoalescer::take()
+{
+    QSet<SdfPath> resynced;
+    for (const NoticeEntry& entry : p->d.entries) {
+        if (NoticeCoalescerPrivate::kind(entry) == NoticeCoalescerPrivate::Resync)
+            resynced.insert(entry.path);
+    }
+
+    NoticeBatch batch;
+    batch.entries.reserve(p->d.entries.size());
+    for (const NoticeEntry& entry : p->d.entries) {
+        switch (NoticeCoalescerPrivate::kind(entry)) {
+        case NoticeCoalescerPrivate::NamespaceEdit: batch.entries.append(entry); break;
+        case NoticeCoalescerPrivate::Resync:
+            if (!p->isCovered(entry.path, false, resynced))
+                batch.entries.append(entry);
+            break;
+        default:
+            if (resynced.isEmpty() || !p->isCovered(entry.path, true, resynced))
+                batch.entries.append(entry);
+            break;
+        }
+    }
+
+    clear();
+    return batch;
+}
+
+NoticeBatch
+NoticeCoalescer::coalesce(const NoticeBatch& batch)
+{
+    NoticeCoalescer coalescer;
+    coalescer.append(batch);
+    return coalescer.take();
+}
+
+}  // namespace usdviewer
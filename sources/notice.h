@@ -6,6 +6,7 @@
 
 #include <QList>
 #include <QMetaType>
+#include <QScopedPointer>
 #include <pxr/base/tf/token.h>
 #include <pxr/usd/sdf/path.h>
 #include <pxr/usd/usd/notice.h>
@@ -60,6 +61,69 @@ struct NoticeBatch {
     QList<NoticeEntry> entries;
 };
 
+class NoticeCoalescerPrivate;
+
+/**
+ * @class NoticeCoalescer
+ * @brief Merges notice batches into a minimal batch.
+ *
+ * Entries are merged as they are appended, so memory stays bounded
+ * by the number of distinct changed paths rather than the number of
+ * notices received:
+ * - duplicate info-only entries are merged and their changed fields combined
+ * - duplicate resync and asset path resync entries are merged
+ * - entries covered by a resync of the same path or an ancestor are dropped
+ *   when the batch is taken
+ *
+ * Namespace edits (rename and reparent pairs) are always preserved.
+ */
+class NoticeCoalescer {
+public:
+    /**
+     * @brief Constructs an empty coalescer.
+     */
+    NoticeCoalescer();
+
+    /**
+     * @brief Destroys the NoticeCoalescer instance.
+     */
+    ~NoticeCoalescer();
+
+    /**
+     * @brief Appends and merges the entries of a batch.
+     */
+    void append(const NoticeBatch& batch);
+
+    /**
+     * @brief Returns whether no entries are pending.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Returns the number of merged entries pending.
+     */
+    qsizetype size() const;
+
+    /**
+     * @brief Discards all pending entries.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the minimal batch and clears the coalescer.
+     */
+    NoticeBatch take();
+
+    /**
+     * @brief Returns a minimal copy of a batch.
+     */
+    static NoticeBatch coalesce(const NoticeBatch& batch);
+
+private:
+    Q_DISABLE_COPY_MOVE(NoticeCoalescer)
+    QScopedPointer<NoticeCoalescerPrivate> p;
+};
+
 }  // namespace usdviewer
 
 // Register for Qt signal/slot usage
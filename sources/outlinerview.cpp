@@ -41,6 +41,7 @@ public Q_SLOTS:
     void selectionChanged(const QList<SdfPath>& paths);
     void stageChanged(UsdStageRefPtr stage, Session::LoadPolicy policy, Session::StageStatus status);
     void depthChanged(int value);
+    void hierarchyChanged();
 
 public:
     void updateDepth(const SdfPath& path = SdfPath());
@@ -63,6 +64,7 @@ OutlinerViewPrivate::init()
     d.context.reset(new ViewContext(d.view.data()));
     d.context->setStageLock(session()->stageLock());
     d.context->setCommandStack(session()->commandStack());
+    d.context->setStatisticsCache(session()->statisticsCache());
     attach(d.ui->depth);
     stageTree()->setHeaderLabels(QStringList() << "Name"
                                                << "");
@@ -85,6 +87,7 @@ OutlinerViewPrivate::init()
     connect(d.ui->expand, &QToolButton::clicked, this, &OutlinerViewPrivate::expand);
     connect(d.ui->follow, &QToolButton::toggled, this, &OutlinerViewPrivate::follow);
     connect(d.ui->depth, &QSlider::valueChanged, this, &OutlinerViewPrivate::depthChanged);
+    connect(stageTree(), &StageTree::hierarchyChanged, this, &OutlinerViewPrivate::hierarchyChanged);
     connect(session(), &Session::maskChanged, this, &OutlinerViewPrivate::maskChanged);
     connect(session(), &Session::stageChanged, this, &OutlinerViewPrivate::stageChanged);
     connect(session(), &Session::primsChanged, this, &OutlinerViewPrivate::primsChanged);
@@ -251,6 +254,18 @@ OutlinerViewPrivate::updateDepth(const SdfPath& path)
     d.ui->depth->setValue(stageTree()->depth(path));
 }
 
+void
+OutlinerViewPrivate::hierarchyChanged()
+{
+    if (!d.ui->depth->isEnabled())
+        return;
+
+    // only the range changes, the current depth is kept
+    SignalGuard::Scope guard(this);
+    const QList<SdfPath> paths = session()->selectionList()->paths();
+    d.ui->depth->setMaximum(stageTree()->maxDepth(paths.size() == 1 ? paths.first() : SdfPath()));
+}
+
 OutlinerView::OutlinerView(QWidget* parent)
     : QWidget(parent)
     , p(new OutlinerViewPrivate())
@@ -0,0 +1,441 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#include "payloadstreamer.h"
+#include "application.h"
+#include "tracelocks.h"
+#include "usdutils.h"
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QThreadPool>
+#include <QTimer>
+#include <pxr/usd/usd/primRange.h>
+#include <pxr/usd/usdGeom/bboxCache.h>
+#include <pxr/usd/usdGeom/imageable.h>
+#include <algorithm>
+#include <memory>
+
+namespace usdviewer {
+class PayloadStreamerPrivate : public QObject {
+public:
+    struct Candidate {
+        SdfPath path;
+        GfRange3d bounds;
+        qint64 lastVisible = -1;
+        bool loaded = false;
+        bool streamed = false;
+        bool manual = false;
+    };
+
+    struct State {
+        QList<Candidate> candidates;
+        bool scanned = false;
+    };
+
+    struct Result {
+        int loaded = 0;
+        int unloaded = 0;
+        bool pending = false;
+    };
+
+    void init();
+    void schedule();
+    void finish(const Result& result, quint64 generation);
+    static void scan(const UsdStageRefPtr& stage, const SdfPath& root, QList<Candidate>& candidates);
+    static void sync(const UsdStageRefPtr& stage, QList<Candidate>& candidates);
+    static void prune(QList<Candidate>& candidates, const QList<SdfPath>& paths);
+    static Result stream(Session* session, State* state, const GfFrustum& frustum, qint64 now, int budget,
+                         qint64 unloadDelay);
+
+public:
+    struct Data {
+        bool enabled = false;
+        bool active = false;
+        bool running = false;
+        bool pending = false;
+        bool frustumChanged = false;
+        bool hasFrustum = false;
+        int budget = 8;
+        int unloadDelay = 10000;
+        quint64 generation = 0;
+        GfFrustum frustum;
+        std::shared_ptr<State> state;
+        QElapsedTimer clock;
+        QTimer timer;
+        QPointer<PayloadStreamer> streamer;
+    };
+    Data d;
+};
+
+void
+PayloadStreamerPrivate::init()
+{
+    d.clock.start();
+    d.timer.setInterval(250);
+    connect(&d.timer, &QTimer::timeout, this, &PayloadStreamerPrivate::schedule);
+}
+
+void
+PayloadStreamerPrivate::schedule()
+{
+    if (!d.enabled || !d.active || d.running || !d.hasFrustum || !d.state)
+        return;
+
+    if (d.state->scanned && !d.frustumChanged && !d.pending)
+        return;
+
+    d.running = true;
+    d.frustumChanged = false;
+
+    const std::shared_ptr<State> state = d.state;
+    const GfFrustum frustum = d.frustum;
+    const qint64 now = d.clock.elapsed();
+    const int budget = d.budget;
+    const qint64 unloadDelay = d.unloadDelay;
+    const quint64 generation = d.generation;
+    const QPointer<PayloadStreamerPrivate> self(this);
+    Session* session = usdviewer::session();
+
+    QThreadPool::globalInstance()->start([self, session, state, frustum, now, budget, unloadDelay, generation]() {
+        Result result;
+        try {
+            result = stream(session, state.get(), frustum, now, budget, unloadDelay);
+        } catch (...) {
+            result = Result();
+        }
+
+        if (!self)
+            return;
+
+        QMetaObject::invokeMethod(
+            self, [self, result, generation]() { self->finish(result, generation); }, Qt::QueuedConnection);
+    });
+}
+
+void
+PayloadStreamerPrivate::finish(const Result& result, quint64 generation)
+{
+    d.running = false;
+    if (generation != d.generation)
+        return;
+
+    d.pending = result.pending;
+    if (result.loaded || result.unloaded)
+        Q_EMIT d.streamer->streamChanged(result.loaded, result.unloaded);
+}
+
+void
+PayloadStreamerPrivate::scan(const UsdStageRefPtr& stage, const SdfPath& root, QList<Candidate>& candidates)
+{
+    const UsdPrim rootPrim = stage->GetPrimAtPath(root);
+    if (!rootPrim)
+        return;
+
+    UsdGeomBBoxCache bboxCache(UsdTimeCode::Default(), UsdGeomImageable::GetOrderedPurposeTokens(), true);
+    UsdPrimRange range(rootPrim, UsdPrimIsActive && UsdPrimIsDefined && !UsdPrimIsAbstract);
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        const UsdPrim prim = *it;
+        if (prim.GetPath() == root)
+            continue;
+
+        if (!stage::isPayload(stage, prim.GetPath()))
+            continue;
+
+        Candidate candidate;
+        candidate.path = prim.GetPath();
+        candidate.bounds = bboxCache.ComputeWorldBound(prim).ComputeAlignedRange();
+        candidate.loaded = prim.IsLoaded();
+        candidates.append(candidate);
+
+        // nested payloads are picked up when the parent payload is streamed in
+        if (!candidate.loaded)
+            it.PruneChildren();
+    }
+}
+
+void
+PayloadStreamerPrivate::sync(const UsdStageRefPtr& stage, QList<Candidate>& candidates)
+{
+    // a load state that differs from the last one seen was changed by hand,
+    // those payloads are left to the user from then on
+    QList<SdfPath> unloadedPaths;
+    for (Candidate& candidate : candidates) {
+        if (candidate.manual)
+            continue;
+
+        const UsdPrim prim = stage->GetPrimAtPath(candidate.path);
+        const bool loaded = prim && prim.IsLoaded();
+        if (loaded == candidate.loaded)
+            continue;
+
+        candidate.loaded = loaded;
+        candidate.streamed = false;
+        candidate.manual = true;
+        if (!loaded)
+            unloadedPaths.append(candidate.path);
+    }
+    prune(candidates, unloadedPaths);
+}
+
+void
+PayloadStreamerPrivate::prune(QList<Candidate>& candidates, const QList<SdfPath>& paths)
+{
+    // nested payloads go away with the payload they were found in
+    if (paths.isEmpty())
+        return;
+
+    candidates.removeIf([&](const Candidate& candidate) {
+        for (const SdfPath& path : paths) {
+            if (candidate.path != path && candidate.path.HasPrefix(path))
+                return true;
+        }
+        return false;
+    });
+}
+
+PayloadStreamerPrivate::Result
+PayloadStreamerPrivate::stream(Session* session, State* state, const GfFrustum& frustum, qint64 now, int budget,
+                               qint64 unloadDelay)
+{
+    Result result;
+    if (!session || !state)
+        return result;
+
+    {
+        READ_LOCKER(locker, session->stageLock(), "stageLock");
+        const UsdStageRefPtr stage = session->stageUnsafe();
+        if (!stage)
+            return result;
+
+        if (!state->scanned) {
+            scan(stage, SdfPath::AbsoluteRootPath(), state->candidates);
+            state->scanned = true;
+        }
+        else {
+            sync(stage, state->candidates);
+        }
+    }
+
+    struct Rank {
+        qsizetype index;
+        double importance;
+    };
+
+    const GfVec3d eye = frustum.GetPosition();
+    QList<Rank> loads;
+    QList<qsizetype> unloads;
+    bool waiting = false;
+
+    for (qsizetype i = 0; i < state->candidates.size(); ++i) {
+        Candidate& candidate = state->candidates[i];
+        if (candidate.manual)
+            continue;
+
+        // payloads without extentsHint or bounds cannot be culled, they are
+        // treated as visible with the lowest importance
+        bool visible = true;
+        double importance = 0.0;
+        if (!candidate.bounds.IsEmpty()) {
+            visible = frustum.Intersects(GfBBox3d(candidate.bounds));
+            const double radius = candidate.bounds.GetSize().GetLength() * 0.5;
+            const double distance = std::max((candidate.bounds.GetMidpoint() - eye).GetLength() - radius, 1e-6);
+            importance = radius / distance;
+        }
+
+        if (visible) {
+            candidate.lastVisible = now;
+            if (!candidate.loaded)
+                loads.append({ i, importance });
+        }
+        else if (candidate.loaded && candidate.streamed) {
+            if (now - candidate.lastVisible > unloadDelay)
+                unloads.append(i);
+            else
+                waiting = true;
+        }
+    }
+
+    std::sort(loads.begin(), loads.end(), [](const Rank& a, const Rank& b) { return a.importance > b.importance; });
+
+    result.pending = waiting || loads.size() > budget || unloads.size() > budget;
+    if (loads.size() > budget)
+        loads.resize(budget);
+    if (unloads.size() > budget)
+        unloads.resize(budget);
+
+    if (loads.isEmpty() && unloads.isEmpty())
+        return result;
+
+    QList<Candidate> nested;
+    QList<SdfPath> unloadedPaths;
+    {
+        WRITE_LOCKER(locker, session->stageLock(), "stageLock");
+        const UsdStageRefPtr stage = session->stageUnsafe();
+        if (!stage)
+            return result;
+
+        // verify against the stage, payloads may have been changed by hand
+        SdfPathSet loadSet;
+        for (const Rank& rank : loads) {
+            Candidate& candidate = state->candidates[rank.index];
+            const UsdPrim prim = stage->GetPrimAtPath(candidate.path);
+            if (!prim)
+                continue;
+
+            if (prim.IsLoaded()) {
+                candidate.loaded = true;
+                candidate.manual = true;
+            }
+            else {
+                loadSet.insert(candidate.path);
+            }
+        }
+
+        SdfPathSet unloadSet;
+        for (qsizetype index : unloads) {
+            Candidate& candidate = state->candidates[index];
+            const UsdPrim prim = stage->GetPrimAtPath(candidate.path);
+            if (!prim || !prim.IsLoaded()) {
+                candidate.loaded = false;
+                candidate.streamed = false;
+                candidate.manual = true;
+                unloadedPaths.append(candidate.path);
+                continue;
+            }
+            unloadSet.insert(candidate.path);
+        }
+
+        if (loadSet.empty() && unloadSet.empty()) {
+            prune(state->candidates, unloadedPaths);
+            return result;
+        }
+
+        stage->LoadAndUnload(loadSet, unloadSet, UsdLoadWithoutDescendants);
+
+        for (const Rank& rank : loads) {
+            Candidate& candidate = state->candidates[rank.index];
+            if (!loadSet.count(candidate.path))
+                continue;
+
+            const UsdPrim prim = stage->GetPrimAtPath(candidate.path);
+            candidate.loaded = prim && prim.IsLoaded();
+            candidate.streamed = candidate.loaded;
+            if (candidate.loaded) {
+                scan(stage, candidate.path, nested);
+                result.loaded++;
+            }
+        }
+
+        for (qsizetype index : unloads) {
+            Candidate& candidate = state->candidates[index];
+            if (!unloadSet.count(candidate.path))
+                continue;
+
+            candidate.loaded = false;
+            candidate.streamed = false;
+            unloadedPaths.append(candidate.path);
+            result.unloaded++;
+        }
+    }
+
+    prune(state->candidates, unloadedPaths);
+
+    if (!nested.isEmpty()) {
+        state->candidates.append(nested);
+        result.pending = true;
+    }
+
+    return result;
+}
+
+PayloadStreamer::PayloadStreamer(QObject* parent)
+    : QObject(parent)
+    , p(new PayloadStreamerPrivate())
+{
+    p->d.streamer = this;
+    p->init();
+}
+
+PayloadStreamer::~PayloadStreamer() = default;
+
+bool
+PayloadStreamer::isEnabled() const
+{
+    return p->d.enabled;
+}
+
+void
+PayloadStreamer::setEnabled(bool enabled)
+{
+    if (p->d.enabled == enabled)
+        return;
+
+    p->d.enabled = enabled;
+    p->d.frustumChanged = true;
+    if (p->d.enabled && p->d.active)
+        p->d.timer.start();
+    else
+        p->d.timer.stop();
+}
+
+int
+PayloadStreamer::budget() const
+{
+    return p->d.budget;
+}
+
+void
+PayloadStreamer::setBudget(int budget)
+{
+    p->d.budget = std::max(1, budget);
+}
+
+int
+PayloadStreamer::unloadDelay() const
+{
+    return p->d.unloadDelay;
+}
+
+void
+PayloadStreamer::setUnloadDelay(int msecs)
+{
+    p->d.unloadDelay = std::max(0, msecs);
+}
+
+void
+PayloadStreamer::updateStage(UsdStageRefPtr stage, Session::LoadPolicy policy)
+{
+    close();
+    if (!stage || policy != Session::LoadPolicy::None)
+        return;
+
+    p->d.active = true;
+    p->d.state = std::make_shared<PayloadStreamerPrivate::State>();
+    if (p->d.enabled)
+        p->d.timer.start();
+}
+
+void
+PayloadStreamer::updateFrustum(const GfFrustum& frustum)
+{
+    if (p->d.hasFrustum && p->d.frustum == frustum)
+        return;
+
+    p->d.frustum = frustum;
+    p->d.hasFrustum = true;
+    p->d.frustumChanged = true;
+}
+
+void
+PayloadStreamer::close()
+{
+    p->d.timer.stop();
+    p->d.generation++;
+    p->d.active = false;
+    p->d.pending = false;
+    p->d.frustumChanged = true;
+    p->d.state.reset();
+}
+
+}  // namespace usdviewer
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#pragma once
+
+#include "session.h"
+#include <QObject>
+#include <QScopedPointer>
+#include <pxr/base/gf/frustum.h>
+#include <pxr/usd/usd/stage.h>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace usdviewer {
+
+class PayloadStreamerPrivate;
+
+/**
+ * @class PayloadStreamer
+ * @brief Camera-driven progressive payload loader.
+ *
+ * Streams payloads of stages opened with LoadPolicy::None in order of
+ * screen-space importance. Payloads inside the view frustum are ranked
+ * by their projected size using extentsHint or bounding box data, and
+ * loaded in budgeted batches on a worker thread. Payloads streamed in
+ * by this class are unloaded again once they have been outside the
+ * frustum for longer than the unload delay.
+ *
+ * Payloads loaded or unloaded by hand are left untouched. The load state
+ * of every candidate is compared against the stage on each pass, and a
+ * payload whose state changed outside the streamer is no longer streamed.
+ */
+class PayloadStreamer : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @brief Constructs the payload streamer.
+     *
+     * @param parent Optional parent object.
+     */
+    PayloadStreamer(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroys the PayloadStreamer instance.
+     */
+    ~PayloadStreamer() override;
+
+    /** @name Streaming Control */
+    ///@{
+
+    /**
+     * @brief Returns whether streaming is enabled.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Enables or disables streaming.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Returns the maximum number of payloads loaded or unloaded per batch.
+     */
+    int budget() const;
+
+    /**
+     * @brief Sets the maximum number of payloads loaded or unloaded per batch.
+     */
+    void setBudget(int budget);
+
+    /**
+     * @brief Returns the time in milliseconds a payload may stay off-screen before unloading.
+     */
+    int unloadDelay() const;
+
+    /**
+     * @brief Sets the time in milliseconds a payload may stay off-screen before unloading.
+     */
+    void setUnloadDelay(int msecs);
+
+    ///@}
+
+    /** @name Stage Updates */
+    ///@{
+
+    /**
+     * @brief Starts or stops streaming for a stage.
+     *
+     * Streaming is only active for stages opened with LoadPolicy::None.
+     *
+     * @param stage USD stage.
+     * @param policy Stage loading policy.
+     */
+    void updateStage(UsdStageRefPtr stage, Session::LoadPolicy policy);
+
+    /**
+     * @brief Updates the view frustum used for ranking payloads.
+     *
+     * @param frustum Current camera frustum.
+     */
+    void updateFrustum(const GfFrustum& frustum);
+
+    /**
+     * @brief Stops streaming and clears all payload state.
+     */
+    void close();
+
+    ///@}
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted when a streaming batch has been applied.
+     *
+     * @param loaded Number of payloads loaded.
+     * @param unloaded Number of payloads unloaded.
+     */
+    void streamChanged(int loaded, int unloaded);
+
+private:
+    Q_DISABLE_COPY_MOVE(PayloadStreamer)
+    QScopedPointer<PayloadStreamerPrivate> p;
+};
+
+}  // namespace usdviewer
@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#include "primcache.h"
+#include "statisticscache.h"
+#include "tracelocks.h"
+#include "usdutils.h"
+#include <QPointer>
+#include <QThreadPool>
+#include <pxr/usd/usd/prim.h>
+#include <algorithm>
+#include <vector>
+
+namespace usdviewer {
+class PrimCachePrivate {
+public:
+    enum Flag : quint16 {
+        Active = 1 << 0,
+        Visible = 1 << 1,
+        Payload = 1 << 2,
+        EditTarget = 1 << 3,
+        Root = 1 << 4,
+        Valid = 1 << 5,
+        Pending = 1 << 6,
+        Used = 1 << 7,
+        Stale = 1 << 8
+    };
+
+    struct Request {
+        int id;
+        quint32 version;
+        SdfPath path;
+    };
+
+    struct Result {
+        int id;
+        quint32 version;
+        TfToken name;
+        TfToken typeName;
+        quint16 flags;
+    };
+
+    void init();
+    void request(int id);
+    void fetch();
+    void store(const std::vector<Result>& results);
+    static Result compute(UsdStageRefPtr stage, const Request& request);
+
+public:
+    struct Data {
+        // one column per field, indexed by row id
+        std::vector<SdfPath> paths;
+        std::vector<TfToken> names;
+        std::vector<TfToken> typeNames;
+        std::vector<quint16> flags;
+        std::vector<quint32> versions;
+        std::vector<int> freeIds;
+        std::vector<Request> requests;
+        bool scheduled = false;
+        UsdStageRefPtr stage;
+        QReadWriteLock* lock = nullptr;
+        QPointer<PrimCache> cache;
+        QPointer<StatisticsCache> statistics;
+    };
+    Data d;
+};
+
+void
+PrimCachePrivate::init()
+{}
+
+void
+PrimCachePrivate::request(int id)
+{
+    d.flags[id] |= Pending;
+    d.requests.push_back({ id, d.versions[id], d.paths[id] });
+    if (d.scheduled)
+        return;
+
+    // rows requested during one paint are fetched together
+    d.scheduled = true;
+    QMetaObject::invokeMethod(d.cache, [this]() { fetch(); }, Qt::QueuedConnection);
+}
+
+void
+PrimCachePrivate::fetch()
+{
+    d.scheduled = false;
+    if (d.requests.empty())
+        return;
+
+    std::vector<Request> requests;
+    requests.swap(d.requests);
+    if (!d.stage || !d.lock)
+        return;
+
+    const UsdStageRefPtr stage = d.stage;
+    QReadWriteLock* lock = d.lock;
+    const QPointer<PrimCache> cache = d.cache;
+    const size_t chunkSize = 256;
+    for (size_t begin = 0; begin < requests.size(); begin += chunkSize) {
+        const size_t end = std::min(begin + chunkSize, requests.size());
+        std::vector<Request> chunk(requests.begin() + begin, requests.begin() + end);
+        QThreadPool::globalInstance()->start([this, cache, stage, lock, chunk]() {
+            std::vector<Result> results;
+            results.reserve(chunk.size());
+            {
+                READ_LOCKER(locker, lock, "stageLock");
+                for (const Request& request : chunk)
+                    results.push_back(compute(stage, request));
+            }
+            if (!cache)
+                return;
+
+            QMetaObject::invokeMethod(
+                cache,
+                [this, cache, results]() {
+                    if (cache)
+                        store(results);
+                },
+                Qt::QueuedConnection);
+        });
+    }
+}
+
+void
+PrimCachePrivate::store(const std::vector<Result>& results)
+{
+    bool changed = false;
+    for (const Result& result : results) {
+        // removed, moved or invalidated rows have a newer version
+        if (result.id >= int(d.versions.size()) || d.versions[result.id] != result.version)
+            continue;
+
+        d.names[result.id] = result.name;
+        d.typeNames[result.id] = result.typeName;
+        d.flags[result.id] = result.flags | Valid | Used;
+        changed = true;
+    }
+    if (changed)
+        Q_EMIT d.cache->rowsChanged();
+}
+
+PrimCachePrivate::Result
+PrimCachePrivate::compute(UsdStageRefPtr stage, const Request& request)
+{
+    Result result { request.id, request.version, TfToken(), TfToken(), Visible | EditTarget };
+    const UsdPrim prim = stage->GetPrimAtPath(request.path);
+    if (!prim) {
+        result.name = request.path.GetNameToken();
+        return result;
+    }
+
+    result.name = prim.GetName();
+    result.typeName = prim.GetTypeName();
+    const bool root = prim.IsPseudoRoot();
+    if (root)
+        result.flags |= Root;
+    if (prim.HasPayload())
+        result.flags |= Payload;
+    if (!stage::isEditTarget(stage, request.path))
+        result.flags &= ~EditTarget;
+    if (prim.IsActive()) {
+        result.flags |= Active;
+        if (!root && !stage::isVisible(stage, request.path))
+            result.flags &= ~Visible;
+    }
+    return result;
+}
+
+PrimCache::PrimCache(QObject* parent)
+    : QObject(parent)
+    , p(new PrimCachePrivate())
+{
+    p->d.cache = this;
+    p->init();
+}
+
+PrimCache::~PrimCache() {}
+
+void
+PrimCache::setStage(UsdStageRefPtr stage, QReadWriteLock* lock)
+{
+    p->d.stage = stage;
+    p->d.lock = lock;
+    for (size_t id = 0; id < p->d.flags.size(); ++id) {
+        if (p->d.flags[id] & PrimCachePrivate::Used)
+            invalidate(int(id));
+    }
+}
+
+int
+PrimCache::insert(const SdfPath& path)
+{
+    int id;
+    if (!p->d.freeIds.empty()) {
+        id = p->d.freeIds.back();
+        p->d.freeIds.pop_back();
+    }
+    else {
+        id = int(p->d.paths.size());
+        p->d.paths.emplace_back();
+        p->d.names.emplace_back();
+        p->d.typeNames.emplace_back();
+        p->d.flags.push_back(0);
+        p->d.versions.push_back(0);
+    }
+    p->d.paths[id] = path;
+    p->d.names[id] = path.GetNameToken();
+    p->d.typeNames[id] = TfToken();
+    p->d.flags[id] = PrimCachePrivate::Used;
+    p->d.versions[id]++;
+    return id;
+}
+
+void
+PrimCache::remove(int id)
+{
+    if (id < 0 || id >= int(p->d.flags.size()) || !(p->d.flags[id] & PrimCachePrivate::Used))
+        return;
+
+    p->d.paths[id] = SdfPath();
+    p->d.names[id] = TfToken();
+    p->d.typeNames[id] = TfToken();
+    p->d.flags[id] = 0;
+    p->d.versions[id]++;
+    p->d.freeIds.push_back(id);
+}
+
+void
+PrimCache::setPath(int id, const SdfPath& path)
+{
+    if (id < 0 || id >= int(p->d.paths.size()))
+        return;
+
+    p->d.paths[id] = path;
+    p->d.names[id] = path.GetNameToken();
+    invalidate(id);
+}
+
+void
+PrimCache::invalidate(int id)
+{
+    if (id < 0 || id >= int(p->d.flags.size()))
+        return;
+
+    // previous values stay visible until the row is painted and fetched again
+    p->d.flags[id] &= ~PrimCachePrivate::Pending;
+    p->d.flags[id] |= PrimCachePrivate::Stale;
+    p->d.versions[id]++;
+}
+
+PrimCache::Row
+PrimCache::row(int id) const
+{
+    Row row;
+    if (id < 0 || id >= int(p->d.flags.size()))
+        return row;
+
+    const quint16 flags = p->d.flags[id];
+    const bool fetch = !(flags & PrimCachePrivate::Valid) || (flags & PrimCachePrivate::Stale);
+    if (fetch && !(flags & PrimCachePrivate::Pending))
+        p->request(id);
+
+    row.name = p->d.names[id];
+    row.typeName = p->d.typeNames[id];
+    row.valid = flags & PrimCachePrivate::Valid;
+    if (row.valid) {
+        row.active = flags & PrimCachePrivate::Active;
+        row.visible = flags & PrimCachePrivate::Visible;
+        row.payload = flags & PrimCachePrivate::Payload;
+        row.editTarget = flags & PrimCachePrivate::EditTarget;
+        row.root = flags & PrimCachePrivate::Root;
+    }
+    return row;
+}
+
+TfToken
+PrimCache::name(int id) const
+{
+    if (id < 0 || id >= int(p->d.names.size()))
+        return TfToken();
+
+    return p->d.names[id];
+}
+
+StatisticsCache*
+PrimCache::statistics() const
+{
+    return p->d.statistics;
+}
+
+void
+PrimCache::setStatistics(StatisticsCache* statistics)
+{
+    p->d.statistics = statistics;
+}
+
+}  // namespace usdviewer
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#pragma once
+
+#include <QObject>
+#include <QReadWriteLock>
+#include <QScopedPointer>
+#include <pxr/usd/usd/stage.h>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace usdviewer {
+
+class PrimCachePrivate;
+class StatisticsCache;
+
+/**
+ * @class PrimCache
+ * @brief Display data cache for outliner rows.
+ *
+ * Stores name, type name, active, visible, payload and edit target state
+ * for each row in separate columns. Rows are read on the GUI thread
+ * without touching the stage; rows that are missing or invalidated are
+ * queued and fetched by worker threads under the stage read lock, and
+ * rowsChanged() is emitted as results arrive.
+ *
+ * Invalidated rows keep their previous values until the new ones are
+ * fetched. All methods must be called from the GUI thread.
+ */
+class PrimCache : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @struct Row
+     * @brief Display data of one row.
+     */
+    struct Row {
+        TfToken name;             ///< Prim name, from the path until fetched.
+        TfToken typeName;         ///< Prim type name.
+        bool active = true;       ///< Prim is active.
+        bool visible = true;      ///< Prim is visible.
+        bool payload = false;     ///< Prim has a payload.
+        bool editTarget = true;   ///< Prim is defined in the edit target.
+        bool root = false;        ///< Prim is the pseudo root.
+        bool valid = false;       ///< Data has been fetched from the stage.
+    };
+
+public:
+    /**
+     * @brief Constructs an empty cache.
+     *
+     * @param parent Optional parent object.
+     */
+    PrimCache(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroys the PrimCache instance.
+     */
+    ~PrimCache() override;
+
+    /**
+     * @brief Sets the stage rows are fetched from and the lock guarding it.
+     *
+     * All rows are invalidated.
+     */
+    void setStage(UsdStageRefPtr stage, QReadWriteLock* lock);
+
+    /**
+     * @brief Adds a row for @p path and returns its id.
+     */
+    int insert(const SdfPath& path);
+
+    /**
+     * @brief Removes a row, its id may be reused.
+     */
+    void remove(int id);
+
+    /**
+     * @brief Moves a row to a new path and invalidates it.
+     */
+    void setPath(int id, const SdfPath& path);
+
+    /**
+     * @brief Invalidates a row so it is fetched again.
+     */
+    void invalidate(int id);
+
+    /**
+     * @brief Returns the display data of a row.
+     *
+     * Never blocks. Rows that are not valid are queued for fetching.
+     */
+    Row row(int id) const;
+
+    /**
+     * @brief Returns the cached name of a row without queueing a fetch.
+     */
+    TfToken name(int id) const;
+
+    /**
+     * @brief Returns the subtree statistics shown in optional columns.
+     */
+    StatisticsCache* statistics() const;
+
+    /**
+     * @brief Sets the subtree statistics shown in optional columns.
+     */
+    void setStatistics(StatisticsCache* statistics);
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted when fetched rows have been stored.
+     */
+    void rowsChanged();
+
+private:
+    Q_DISABLE_COPY_MOVE(PrimCache)
+    QScopedPointer<PrimCachePrivate> p;
+};
+
+}  // namespace usdviewer
@@ -0,0 +1,431 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#include "primindex.h"
+#include "qtutils.h"
+#include "tracelocks.h"
+#include "usdutils.h"
+#include <QCoreApplication>
+#include <QMutex>
+#include <QPointer>
+#include <QRegularExpression>
+#include <QThreadPool>
+#include <pxr/usd/usd/primRange.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace usdviewer {
+class PrimIndexPrivate {
+public:
+    struct Table {
+        std::vector<SdfPath> paths;
+        std::vector<std::string> names;  // lower-case
+        std::vector<TfToken> types;
+        std::vector<bool> payloads;
+    };
+
+    struct State {
+        QMutex mutex;
+        QMutex buildMutex;
+        UsdStageRefPtr stage;
+        QReadWriteLock* lock = nullptr;
+        quint64 generation = 0;
+        std::shared_ptr<const Table> table;
+        QList<SdfPath> stalePaths;  // resynced subtrees not yet patched into the table
+        std::atomic<int> searchId { 0 };
+    };
+
+    enum class PayloadState { Any, Loaded, Unloaded };
+
+    struct Term {
+        bool path = false;
+        std::string text;  // lower-case substring, empty if regex is used
+        QRegularExpression regex;
+    };
+
+    struct Query {
+        QList<Term> terms;
+        std::vector<std::string> types;  // lower-case
+        PayloadState payload = PayloadState::Any;
+    };
+
+    void init();
+    static std::shared_ptr<const Table> acquire(const std::shared_ptr<State>& state);
+    static std::shared_ptr<const Table> build(UsdStageRefPtr stage, QReadWriteLock* lock);
+    static std::shared_ptr<const Table> patch(const Table& table, const QList<SdfPath>& paths, UsdStageRefPtr stage,
+                                              QReadWriteLock* lock);
+    static void append(Table& table, const UsdPrim& root);
+    static Query parse(const QString& text);
+    static std::string lower(const std::string& text);
+    static bool contains(const std::string& text, const std::string& lowerPattern);
+    static bool matches(const Table& table, size_t index, const Query& query,
+                        std::unordered_map<TfToken, bool, TfToken::HashFunctor>& typeMatches);
+    static void run(const std::shared_ptr<State>& state, const Query& query, int id, QPointer<PrimIndex> index);
+    static void filterLoaded(std::vector<size_t>& rows, const Table& table, UsdStageRefPtr stage, QReadWriteLock* lock,
+                             PayloadState payload);
+
+public:
+    struct Data {
+        std::shared_ptr<State> state;
+    };
+    Data d;
+};
+
+void
+PrimIndexPrivate::init()
+{
+    d.state = std::make_shared<State>();
+}
+
+std::shared_ptr<const PrimIndexPrivate::Table>
+PrimIndexPrivate::acquire(const std::shared_ptr<State>& state)
+{
+    // one build at a time, searches queued behind it reuse its table
+    QMutexLocker buildLocker(&state->buildMutex);
+    UsdStageRefPtr stage;
+    QReadWriteLock* lock = nullptr;
+    quint64 generation = 0;
+    std::shared_ptr<const Table> current;
+    QList<SdfPath> stalePaths;
+    {
+        QMutexLocker locker(&state->mutex);
+        if (state->table && state->stalePaths.isEmpty())
+            return state->table;
+        stage = state->stage;
+        lock = state->lock;
+        generation = state->generation;
+        current = state->table;
+        stalePaths = state->stalePaths;
+    }
+    if (!stage || !lock)
+        return nullptr;
+
+    // stale paths are only dropped once their patch is stored, a newer
+    // invalidate meanwhile patches them again together with its own
+    std::shared_ptr<const Table> table = current ? patch(*current, stalePaths, stage, lock) : build(stage, lock);
+    {
+        QMutexLocker locker(&state->mutex);
+        if (generation == state->generation) {
+            state->table = table;
+            state->stalePaths.clear();
+        }
+    }
+    return table;
+}
+
+std::shared_ptr<const PrimIndexPrivate::Table>
+PrimIndexPrivate::build(UsdStageRefPtr stage, QReadWriteLock* lock)
+{
+    auto table = std::make_shared<Table>();
+    READ_LOCKER(locker, lock, "stageLock");
+    append(*table, stage->GetPseudoRoot());
+    return table;
+}
+
+std::shared_ptr<const PrimIndexPrivate::Table>
+PrimIndexPrivate::patch(const Table& table, const QList<SdfPath>& paths, UsdStageRefPtr stage, QReadWriteLock* lock)
+{
+    // rows under resynced paths are dropped and only those subtrees are
+    // traversed again, the rest of the table is copied as is
+    const QList<SdfPath> roots = path::minimalRootPaths(paths);
+    const SdfPathSet rootSet(roots.begin(), roots.end());
+    if (rootSet.count(SdfPath::AbsoluteRootPath()))
+        return build(stage, lock);
+
+    auto patched = std::make_shared<Table>();
+    patched->paths.reserve(table.paths.size());
+    patched->names.reserve(table.paths.size());
+    patched->types.reserve(table.paths.size());
+    patched->payloads.reserve(table.paths.size());
+    for (size_t i = 0; i < table.paths.size(); ++i) {
+        if (SdfPathFindLongestPrefix(rootSet, table.paths[i]) != rootSet.end())
+            continue;
+        patched->paths.push_back(table.paths[i]);
+        patched->names.push_back(table.names[i]);
+        patched->types.push_back(table.types[i]);
+        patched->payloads.push_back(table.payloads[i]);
+    }
+
+    READ_LOCKER(locker, lock, "stageLock");
+    for (const SdfPath& root : roots) {
+        // removed prims are gone from the stage and leave no rows behind
+        const UsdPrim prim = stage->GetPrimAtPath(root);
+        if (prim)
+            append(*patched, prim);
+    }
+    return patched;
+}
+
+void
+PrimIndexPrivate::append(Table& table, const UsdPrim& root)
+{
+    UsdPrimRange range(root, UsdPrimAllPrimsPredicate);
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        if (it->IsPseudoRoot())
+            continue;
+        table.paths.push_back(it->GetPath());
+        table.names.push_back(lower(it->GetName().GetString()));
+        table.types.push_back(it->GetTypeName());
+        table.payloads.push_back(it->HasAuthoredPayloads());
+    }
+}
+
+PrimIndexPrivate::Query
+PrimIndexPrivate::parse(const QString& text)
+{
+    Query query;
+    for (const QString& word : text.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts)) {
+        if (word.startsWith("type:", Qt::CaseInsensitive)) {
+            for (const QString& type : word.mid(5).split(',', Qt::SkipEmptyParts))
+                query.types.push_back(qt::QStringToString(type.toLower()));
+            continue;
+        }
+        if (word.startsWith("payload:", Qt::CaseInsensitive)) {
+            const QString state = word.mid(8).toLower();
+            if (state == "loaded")
+                query.payload = PayloadState::Loaded;
+            else if (state == "unloaded")
+                query.payload = PayloadState::Unloaded;
+            continue;
+        }
+
+        Term term;
+        if (word.startsWith("re:", Qt::CaseInsensitive)) {
+            term.regex = QRegularExpression(word.mid(3), QRegularExpression::CaseInsensitiveOption);
+            term.path = word.mid(3).contains('/');
+        }
+        else if (word.contains('*') || word.contains('?')) {
+            term.regex = QRegularExpression::fromWildcard(word, Qt::CaseInsensitive,
+                                                          QRegularExpression::NonPathWildcardConversion);
+            term.path = word.contains('/');
+        }
+        else {
+            term.text = qt::QStringToString(word.toLower());
+            term.path = word.contains('/');
+        }
+        // an invalid expression while typing matches nothing rather than everything
+        if (term.text.empty() && !term.regex.isValid())
+            term.regex = QRegularExpression("(?!)");
+        query.terms.append(term);
+    }
+    return query;
+}
+
+std::string
+PrimIndexPrivate::lower(const std::string& text)
+{
+    std::string result(text);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return char(std::tolower(c)); });
+    return result;
+}
+
+bool
+PrimIndexPrivate::contains(const std::string& text, const std::string& lowerPattern)
+{
+    auto it = std::search(text.begin(), text.end(), lowerPattern.begin(), lowerPattern.end(),
+                          [](char a, char b) { return char(std::tolower((unsigned char)a)) == b; });
+    return it != text.end() || lowerPattern.empty();
+}
+
+bool
+PrimIndexPrivate::matches(const Table& table, size_t index, const Query& query,
+                          std::unordered_map<TfToken, bool, TfToken::HashFunctor>& typeMatches)
+{
+    if (query.payload != PayloadState::Any && !table.payloads[index])
+        return false;
+
+    if (!query.types.empty()) {
+        // few distinct types per stage, compare each once
+        const TfToken& type = table.types[index];
+        auto it = typeMatches.find(type);
+        if (it == typeMatches.end()) {
+            const std::string name = lower(type.GetString());
+            const bool match = std::find(query.types.begin(), query.types.end(), name) != query.types.end();
+            it = typeMatches.emplace(type, match).first;
+        }
+        if (!it->second)
+            return false;
+    }
+
+    for (const Term& term : query.terms) {
+        if (!term.text.empty()) {
+            const bool match = term.path ? contains(table.paths[index].GetString(), term.text)
+                                         : table.names[index].find(term.text) != std::string::npos;
+            if (!match)
+                return false;
+        }
+        else {
+            const std::string& subject = term.path ? table.paths[index].GetString() : table.names[index];
+            if (!term.regex.match(qt::StringToQString(subject)).hasMatch())
+                return false;
+        }
+    }
+    return true;
+}
+
+void
+PrimIndexPrivate::run(const std::shared_ptr<State>& state, const Query& query, int id, QPointer<PrimIndex> index)
+{
+    // the index pointer is only checked on the gui thread, the worker never touches it
+    auto post = [index, id](const QList<SdfPath>& paths, bool finished, int count) {
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [index, id, paths, finished, count]() {
+                if (!index)
+                    return;
+                if (!paths.isEmpty())
+                    Q_EMIT index->resultsReady(id, paths);
+                if (finished)
+                    Q_EMIT index->searchFinished(id, count);
+            },
+            Qt::QueuedConnection);
+    };
+
+    UsdStageRefPtr stage;
+    QReadWriteLock* lock = nullptr;
+    {
+        QMutexLocker locker(&state->mutex);
+        stage = state->stage;
+        lock = state->lock;
+    }
+    if (!stage || !lock) {
+        post(QList<SdfPath>(), true, 0);
+        return;
+    }
+
+    std::shared_ptr<const Table> table = acquire(state);
+    if (!table || state->searchId.load() != id) {
+        if (!table)
+            post(QList<SdfPath>(), true, 0);
+        return;
+    }
+
+    // first chunk is small so the outliner fills quickly, later ones amortize the queued calls
+    const size_t chunkSize = 1 << 16;
+    size_t resultSize = 256;
+    std::unordered_map<TfToken, bool, TfToken::HashFunctor> typeMatches;
+    std::vector<size_t> rows;
+    QList<SdfPath> paths;
+    int count = 0;
+    for (size_t begin = 0; begin < table->paths.size(); begin += chunkSize) {
+        if (state->searchId.load() != id)
+            return;
+
+        const size_t end = std::min(begin + chunkSize, table->paths.size());
+        rows.clear();
+        for (size_t i = begin; i < end; ++i) {
+            if (matches(*table, i, query, typeMatches))
+                rows.push_back(i);
+        }
+
+        if (query.payload != PayloadState::Any)
+            filterLoaded(rows, *table, stage, lock, query.payload);
+
+        for (size_t row : rows)
+            paths.append(table->paths[row]);
+        count += int(rows.size());
+        if (paths.size() >= qsizetype(resultSize)) {
+            post(paths, false, count);
+            paths.clear();
+            resultSize = 4096;
+        }
+    }
+    post(paths, true, count);
+}
+
+void
+PrimIndexPrivate::filterLoaded(std::vector<size_t>& rows, const Table& table, UsdStageRefPtr stage,
+                               QReadWriteLock* lock, PayloadState payload)
+{
+    if (rows.empty())
+        return;
+
+    // load state changes without resyncs, so it is read from the stage,
+    // once per chunk under a single read lock
+    const bool wantLoaded = payload == PayloadState::Loaded;
+    READ_LOCKER(locker, lock, "stageLock");
+    rows.erase(std::remove_if(rows.begin(), rows.end(),
+                              [&](size_t row) {
+                                  const UsdPrim prim = stage->GetPrimAtPath(table.paths[row]);
+                                  return !prim || prim.IsLoaded() != wantLoaded;
+                              }),
+               rows.end());
+}
+
+PrimIndex::PrimIndex(QObject* parent)
+    : QObject(parent)
+    , p(new PrimIndexPrivate())
+{
+    p->init();
+}
+
+PrimIndex::~PrimIndex()
+{
+    cancel();
+}
+
+void
+PrimIndex::setStage(UsdStageRefPtr stage, QReadWriteLock* lock)
+{
+    cancel();
+    {
+        QMutexLocker locker(&p->d.state->mutex);
+        p->d.state->stage = stage;
+        p->d.state->lock = lock;
+        p->d.state->generation++;
+        p->d.state->table.reset();
+        p->d.state->stalePaths.clear();
+    }
+    if (!stage)
+        return;
+
+    std::shared_ptr<PrimIndexPrivate::State> state = p->d.state;
+    QThreadPool::globalInstance()->start([state]() { PrimIndexPrivate::acquire(state); });
+}
+
+void
+PrimIndex::invalidate()
+{
+    QMutexLocker locker(&p->d.state->mutex);
+    p->d.state->generation++;
+    p->d.state->table.reset();
+    p->d.state->stalePaths.clear();
+}
+
+void
+PrimIndex::invalidate(const QList<SdfPath>& paths)
+{
+    if (paths.isEmpty())
+        return;
+
+    QMutexLocker locker(&p->d.state->mutex);
+    p->d.state->generation++;
+    if (p->d.state->table)
+        p->d.state->stalePaths.append(paths);
+}
+
+int
+PrimIndex::search(const QString& query)
+{
+    const int id = ++p->d.state->searchId;
+    std::shared_ptr<PrimIndexPrivate::State> state = p->d.state;
+    const PrimIndexPrivate::Query parsed = PrimIndexPrivate::parse(query);
+    const QPointer<PrimIndex> index = this;
+    QThreadPool::globalInstance()->start(
+        [state, parsed, id, index]() { PrimIndexPrivate::run(state, parsed, id, index); });
+    return id;
+}
+
+void
+PrimIndex::cancel()
+{
+    ++p->d.state->searchId;
+}
+
+}  // namespace usdviewer
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QScopedPointer>
+#include <pxr/usd/usd/stage.h>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace usdviewer {
+
+class PrimIndexPrivate;
+
+/**
+ * @class PrimIndex
+ * @brief Background search index over the prims of a stage.
+ *
+ * Keeps a flat table of prim paths, lower-case names, type names and
+ * payload flags, built on a worker thread under the stage read lock the
+ * first time it is needed after the stage changes or is invalidated.
+ *
+ * Searches run on a worker as well and deliver matches in chunks through
+ * resultsReady(), so the caller can show results while the scan is still
+ * running. Starting a new search cancels the previous one.
+ *
+ * Query syntax, terms are separated by whitespace and must all match:
+ * @code
+ * chair          name contains "chair", case-insensitive
+ * chair_*        glob on the name, '*' and '?' wildcards
+ * /World/Set/*   glob or substring on the full path when the term has '/'
+ * re:^Geo\d+$    regular expression on the name
+ * type:Mesh,Xform  prim type, comma separated
+ * payload:loaded   payload state, one of any, loaded or unloaded
+ * @endcode
+ */
+class PrimIndex : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @brief Constructs an empty index.
+     *
+     * @param parent Optional parent object.
+     */
+    PrimIndex(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroys the PrimIndex instance.
+     */
+    ~PrimIndex() override;
+
+    /**
+     * @brief Sets the stage to index and the lock guarding it.
+     *
+     * The previous table is dropped and a new one is built in the
+     * background.
+     */
+    void setStage(UsdStageRefPtr stage, QReadWriteLock* lock);
+
+    /**
+     * @brief Marks the table stale after structural stage changes.
+     *
+     * The table is rebuilt by the next search.
+     */
+    void invalidate();
+
+    /**
+     * @brief Marks the subtrees of resynced paths stale.
+     *
+     * The next search patches the table, only these subtrees are
+     * traversed again.
+     */
+    void invalidate(const QList<SdfPath>& paths);
+
+    /**
+     * @brief Starts a search and returns its id.
+     *
+     * @param query Query text, see the class description.
+     *
+     * @return Search id passed to resultsReady() and searchFinished().
+     */
+    int search(const QString& query);
+
+    /**
+     * @brief Cancels the running search, if any.
+     */
+    void cancel();
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted with each chunk of matching prim paths.
+     *
+     * @param id Search id.
+     * @param paths Matches found since the previous chunk.
+     */
+    void resultsReady(int id, const QList<SdfPath>& paths);
+
+    /**
+     * @brief Emitted when a search has scanned the whole table.
+     *
+     * @param id Search id.
+     * @param count Total number of matches.
+     */
+    void searchFinished(int id, int count);
+
+private:
+    Q_DISABLE_COPY_MOVE(PrimIndex)
+    QScopedPointer<PrimIndexPrivate> p;
+};
+
+}  // namespace usdviewer
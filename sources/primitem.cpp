@@ -6,9 +6,12 @@
 #include "application.h"
 #include "command.h"
 #include "qtutils.h"
+#include "statisticscache.h"
 #include "style.h"
 #include "usdutils.h"
+#include <QHeaderView>
 #include <QIcon>
+#include <QLocale>
 #include <QPixmap>
 #include <QPointer>
 #include <pxr/usd/usd/prim.h>
@@ -22,20 +25,16 @@ namespace usdviewer {
 class PrimItemPrivate {
 public:
     void init();
-    void updateCache();
+    PrimCache::Row row() const;
+    qint64 statistic(int column) const;
     struct Data {
-        UsdStageRefPtr stage;
+        QPointer<PrimCache> cache;
         SdfPath path;
         PrimItem* item = nullptr;
-        bool dirty = true;
-        bool visible = true;
-        bool active = true;
-        bool hasPayload = false;
-        bool isEditTarget = true;
-        bool isRoot = false;
+        int row = -1;
+        int stageIndex = 0;
+        bool populated = false;
         QString editName;
-        QString name;
-        QString typeName;
     };
     Data d;
 };
@@ -46,79 +45,105 @@ PrimItemPrivate::init()
     d.item->setFlags(d.item->flags() | Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable
                      | Qt::ItemIsEditable);
     d.item->setCheckState(0, Qt::Unchecked);
+    if (d.cache)
+        d.row = d.cache->insert(d.path);
 }
 
-void
-PrimItemPrivate::updateCache()
+PrimCache::Row
+PrimItemPrivate::row() const
 {
-    if (!d.dirty)
-        return;
-    d.visible = true;
-    d.active = false;
-    d.hasPayload = false;
-    d.isEditTarget = true;
-    d.isRoot = false;
-    d.name.clear();
-    d.typeName.clear();
-    if (!d.stage) {
-        d.dirty = false;
-        return;
+    if (!d.cache) {
+        PrimCache::Row row;
+        row.name = d.path.GetNameToken();
+        return row;
     }
+    return d.cache->row(d.row);
+}
 
-    const UsdPrim prim = d.stage->GetPrimAtPath(d.path);
-    d.isRoot = prim == d.stage->GetPseudoRoot();
-
-    if (prim) {
-        d.active = prim.IsActive();
-        d.hasPayload = prim.HasPayload();
-        d.name = StringToQString(prim.GetName().GetString());
-        d.typeName = StringToQString(prim.GetTypeName().GetString());
-        d.isEditTarget = stage::isEditTarget(d.stage, d.path);
-
-        if (d.active && prim != d.stage->GetPseudoRoot())
-            d.visible = stage::isVisible(d.stage, d.path);
-    }
-    else {
-        d.name = StringToQString(d.path.GetName());
+qint64
+PrimItemPrivate::statistic(int column) const
+{
+    StatisticsCache* statistics = d.cache ? d.cache->statistics() : nullptr;
+    if (!statistics || !statistics->isEnabled())
+        return 0;
+
+    const StatisticsCache::Entry entry = statistics->entry(d.path);
+    switch (column) {
+    case PrimItem::Prims: return entry.descendants;
+    case PrimItem::Points: return entry.vertices;
+    case PrimItem::Faces: return entry.faces;
+    case PrimItem::PayloadSize: return entry.payloadBytes;
+    default: return 0;
     }
-
-    d.dirty = false;
 }
 
-PrimItem::PrimItem(QTreeWidget* parent, const UsdStageRefPtr& stage, const SdfPath& path)
+PrimItem::PrimItem(QTreeWidget* parent, PrimCache* cache, const SdfPath& path)
     : TreeItem(parent)
     , p(new PrimItemPrivate())
 {
     p->d.item = this;
-    p->d.stage = stage;
+    p->d.cache = cache;
     p->d.path = path;
     p->init();
 }
 
-PrimItem::PrimItem(QTreeWidgetItem* parent, const UsdStageRefPtr& stage, const SdfPath& path)
+PrimItem::PrimItem(QTreeWidgetItem* parent, PrimCache* cache, const SdfPath& path)
     : TreeItem(parent)
     , p(new PrimItemPrivate())
 {
     p->d.item = this;
-    p->d.stage = stage;
+    p->d.cache = cache;
     p->d.path = path;
     p->init();
 }
 
-PrimItem::~PrimItem() = default;
+PrimItem::~PrimItem()
+{
+    if (p->d.cache)
+        p->d.cache->remove(p->d.row);
+}
 
 QVariant
 PrimItem::data(int column, int role) const
 {
-    p->updateCache();
+    if (role == PrimItem::Path)
+        return StringToQString(p->d.path.GetString());
+
+    if (column >= Prims) {
+        if (role == Qt::TextAlignmentRole)
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+
+        if (role != Qt::DisplayRole)
+            return TreeItem::data(column, role);
+
+        StatisticsCache* statistics = p->d.cache ? p->d.cache->statistics() : nullptr;
+        if (!statistics || !statistics->isEnabled())
+            return QString();
+
+        // placeholder until the subtree has been computed
+        if (!statistics->isComputed(p->d.path))
+            return QString("...");
+
+        const qint64 value = p->statistic(column);
+        if (column == PayloadSize)
+            return value > 0 ? QLocale().formattedDataSize(value) : QString();
+
+        return QLocale().toString(value);
+    }
+
+    if (role != Qt::DisplayRole && role != Qt::EditRole && role != Qt::ToolTipRole && role != Qt::DecorationRole
+        && role != PrimItem::EditName)
+        return TreeItem::data(column, role);
+
+    const PrimCache::Row row = p->row();
     const SdfPath path = p->d.path;
 
     if (column == Name) {
         if (role == Qt::DisplayRole)
-            return p->d.name;
+            return StringToQString(row.name.GetString());
 
         if (role == Qt::EditRole)
-            return p->d.editName.isEmpty() ? p->d.name : p->d.editName;
+            return p->d.editName.isEmpty() ? StringToQString(row.name.GetString()) : p->d.editName;
 
         if (role == PrimItem::EditName)
             return p->d.editName;
@@ -132,36 +157,37 @@ PrimItem::data(int column, int role) const
     }
 
     if (role == Qt::ToolTipRole) {
-        if (p->d.name.isEmpty())
+        if (row.name.IsEmpty())
             return QVariant();
 
-        return QString("%1 (%2)").arg(StringToQString(path.GetString())).arg(p->d.typeName);
+        return QString("%1 (%2)").arg(StringToQString(path.GetString()), StringToQString(row.typeName.GetString()));
     }
 
     if (role == Qt::DecorationRole && column == Name) {
         Style::IconRole iconRole = Style::IconRole::Prim;
 
-        if (p->d.typeName == "Material" || p->d.typeName == "Shader")
+        static const TfToken materialToken("Material");
+        static const TfToken shaderToken("Shader");
+        static const TfToken meshToken("Mesh");
+        if (row.typeName == materialToken || row.typeName == shaderToken)
             iconRole = Style::IconRole::Material;
-        else if (p->d.typeName == "Mesh")
+        else if (row.typeName == meshToken)
             iconRole = Style::IconRole::Mesh;
 
-        if (p->d.hasPayload)
+        if (row.payload)
             iconRole = Style::IconRole::Payload;
 
         return QIcon(style()->icon(iconRole, Style::UIScale::Medium));
     }
 
     if (role == Qt::DecorationRole && column == Vis) {
-        if (!p->d.active || p->d.isRoot)
+        // no icon until the state is known, rather than a wrong one
+        if (!row.valid || !row.active || row.root)
             return QVariant();
 
-        return style()->icon(p->d.visible ? Style::IconRole::Visible : Style::IconRole::Hidden, Style::UIScale::Medium);
+        return style()->icon(row.visible ? Style::IconRole::Visible : Style::IconRole::Hidden, Style::UIScale::Medium);
     }
 
-    if (role == PrimItem::Path)
-        return StringToQString(path.GetString());
-
     return TreeItem::data(column, role);
 }
 
@@ -171,9 +197,7 @@ PrimItem::setData(int column, int role, const QVariant& value)
     if (column == Name && (role == Qt::EditRole || role == PrimItem::EditName)) {
         const QString newName = value.toString().trimmed();
 
-        p->updateCache();
-
-        if (newName.isEmpty() || newName == p->d.name) {
+        if (newName.isEmpty() || newName == StringToQString(p->row().name.GetString())) {
             p->d.editName.clear();
             TreeItem::setData(column, PrimItem::EditName, QString());
             return;
@@ -187,6 +211,25 @@ PrimItem::setData(int column, int role, const QVariant& value)
     TreeItem::setData(column, role, value);
 }
 
+bool
+PrimItem::operator<(const QTreeWidgetItem& other) const
+{
+    const PrimItem& item = static_cast<const PrimItem&>(other);
+    const QTreeWidget* tree = treeWidget();
+    if (!tree || !tree->header()->isSortIndicatorShown())
+        return p->d.stageIndex < item.p->d.stageIndex;
+
+    // compare cached values only, sorting must not queue fetches for the whole tree
+    const int column = tree->sortColumn();
+    if (column >= Prims)
+        return p->statistic(column) < item.p->statistic(column);
+
+    if (column == Name && p->d.cache && item.p->d.cache)
+        return p->d.cache->name(p->d.row) < item.p->d.cache->name(item.p->d.row);
+
+    return p->d.stageIndex < item.p->d.stageIndex;
+}
+
 SdfPath
 PrimItem::path() const
 {
@@ -200,31 +243,60 @@ PrimItem::setPath(const SdfPath& path)
         return;
 
     p->d.path = path;
-    p->d.dirty = true;
     p->d.editName.clear();
+    if (p->d.cache)
+        p->d.cache->setPath(p->d.row, path);
 }
 
 void
 PrimItem::invalidate()
 {
-    p->d.dirty = true;
     p->d.editName.clear();
+    if (p->d.cache)
+        p->d.cache->invalidate(p->d.row);
+}
+
+int
+PrimItem::stageIndex() const
+{
+    return p->d.stageIndex;
+}
+
+void
+PrimItem::setStageIndex(int index)
+{
+    p->d.stageIndex = index;
+}
+
+bool
+PrimItem::isPopulated() const
+{
+    return p->d.populated;
+}
+
+void
+PrimItem::setPopulated(bool populated)
+{
+    p->d.populated = populated;
 }
 
 TreeItem::ItemStates
 PrimItem::itemStates() const
 {
-    p->updateCache();
-
+    const PrimCache::Row row = p->row();
     ItemStates states = None;
 
-    if (!p->d.active)
+    // neutral until first fetched, so rows are not dimmed while scrolling
+    if (!row.valid)
+        return Visible;
+
+    if (!row.active)
         return states;
 
-    if (p->d.visible)
+    if (row.visible)
         states |= Visible;
 
-    if (!p->d.isEditTarget)
+    if (!row.editTarget)
         states |= ReadOnly;
 
     return states;
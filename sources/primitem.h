@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "primcache.h"
 #include "treeitem.h"
 #include <pxr/usd/usd/stage.h>
 
@@ -19,7 +20,8 @@ class PrimItemPrivate;
  *
  * Used by StageTree to represent a prim within the USD stage.
  * Each item corresponds to a prim path and displays information
- * such as the prim name, type, and visibility state.
+ * such as the prim name, type, and visibility state, read from a
+ * shared PrimCache row so painting never touches the stage.
  */
 class PrimItem : public TreeItem {
 public:
@@ -29,27 +31,31 @@ public:
      * @brief Column indices used by the stage tree.
      */
     enum Column {
-        Name = 0,  ///< Name column.
-        Vis = 1    ///< Visibility state column.
+        Name = 0,        ///< Name column.
+        Vis = 1,         ///< Visibility state column.
+        Prims = 2,       ///< Descendant prim count column.
+        Points = 3,      ///< Subtree mesh point count column.
+        Faces = 4,       ///< Subtree mesh face count column.
+        PayloadSize = 5  ///< Subtree payload asset size column.
     };
 
     /**
      * @brief Constructs a root-level prim item.
      *
      * @param parent Parent tree widget.
-     * @param stage  USD stage containing the prim.
+     * @param cache  Display data cache shared by the tree.
      * @param path   Path of the prim represented by the item.
      */
-    PrimItem(QTreeWidget* parent, const UsdStageRefPtr& stage, const SdfPath& path);
+    PrimItem(QTreeWidget* parent, PrimCache* cache, const SdfPath& path);
 
     /**
      * @brief Constructs a child prim item.
      *
      * @param parent Parent tree item.
-     * @param stage  USD stage containing the prim.
+     * @param cache  Display data cache shared by the tree.
      * @param path   Path of the prim represented by the item.
      */
-    PrimItem(QTreeWidgetItem* parent, const UsdStageRefPtr& stage, const SdfPath& path);
+    PrimItem(QTreeWidgetItem* parent, PrimCache* cache, const SdfPath& path);
 
     /**
      * @brief Destroys the PrimItem instance.
@@ -71,6 +77,14 @@ public:
      */
     void setData(int column, int role, const QVariant& value) override;
 
+    /**
+     * @brief Compares items for sorting.
+     *
+     * Statistics columns compare numerically, other columns by text.
+     * Without a sort indicator items compare by stage index.
+     */
+    bool operator<(const QTreeWidgetItem& other) const override;
+
     /**
      * @brief Returns the prim path for this item.
      */
@@ -84,11 +98,34 @@ public:
     /**
       * @brief Marks the item's cached data as invalid.
       *
-      * Forces the item to refresh its cached state (e.g. visibility, payload)
-      * on the next access or update.
+      * The cached state (e.g. visibility, payload) is fetched again in the
+      * background the next time the item is painted.
       */
     void invalidate();
 
+    /**
+     * @brief Returns the position of the prim among its siblings.
+     */
+    int stageIndex() const;
+
+    /**
+     * @brief Sets the position used to restore stage order.
+     */
+    void setStageIndex(int index);
+
+    /**
+     * @brief Returns whether child items have been created.
+     *
+     * Children are created on demand, the first time a branch is
+     * expanded or a path below it is needed.
+     */
+    bool isPopulated() const;
+
+    /**
+     * @brief Marks whether child items have been created.
+     */
+    void setPopulated(bool populated);
+
     /**
      * @brief Returns semantic state flags for the item.
      *
@@ -186,6 +186,8 @@ void
 ProgressViewPrivate::cancel()
 {
     session()->cancelProgressBlock();
+    session()->cancelLoad();
+    session()->cancelExports();
 }
 
 void
@@ -6,6 +6,7 @@
 #include "commandstack.h"
 #include "selectionlist.h"
 #include "session.h"
+#include "stagegenerator.h"
 
 #undef slots
 #include <Python.h>
@@ -688,12 +689,21 @@ PySession_load(PySessionObject* self, PyObject* args, PyObject* kwargs)
 
     const char* filename = nullptr;
     long policy = static_cast<long>(Session::LoadPolicy::All);
+    PyObject* pyMask = nullptr;
+    const char* loadRules = nullptr;
 
-    static const char* keywords[] = { "filename", "policy", nullptr };
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|l", const_cast<char**>(keywords), &filename, &policy))
+    static const char* keywords[] = { "filename", "policy", "mask", "loadRules", nullptr };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|lOz", const_cast<char**>(keywords), &filename, &policy, &pyMask,
+                                     &loadRules))
         return nullptr;
 
-    const bool ok = self->session->loadFromFile(QString::fromUtf8(filename), toLoadPolicy(policy));
+    Session::LoadOptions options;
+    if (!pyToPathList(pyMask, &options.mask))
+        return nullptr;
+    if (loadRules)
+        options.loadRules = QString::fromUtf8(loadRules);
+
+    const bool ok = self->session->loadFromFile(QString::fromUtf8(filename), options, toLoadPolicy(policy));
     return PyBool_FromLong(ok);
 }
 
@@ -755,11 +765,17 @@ PySession_flattenPaths(PySessionObject* self, PyObject* args)
 }
 
 static PyObject*
-PySession_reload(PySessionObject* self)
+PySession_reload(PySessionObject* self, PyObject* args, PyObject* kwargs)
 {
     if (!checkSession(self->session))
         return nullptr;
-    return PyBool_FromLong(self->session->reload());
+
+    int changed = 0;
+    static const char* keywords[] = { "changed", nullptr };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|p", const_cast<char**>(keywords), &changed))
+        return nullptr;
+
+    return PyBool_FromLong(self->session->reload(changed ? Session::ReloadMode::Changed : Session::ReloadMode::Full));
 }
 
 static PyObject*
@@ -1005,12 +1021,14 @@ static PyMethodDef PySession_methods[]
           "Check whether the progress block was cancelled" },
 
         { "newStage", (PyCFunction)PySession_newStage, METH_VARARGS | METH_KEYWORDS, "Create a new stage" },
-        { "load", (PyCFunction)PySession_load, METH_VARARGS | METH_KEYWORDS, "Load a USD stage from file" },
+        { "load", (PyCFunction)PySession_load, METH_VARARGS | METH_KEYWORDS,
+          "Load a USD stage from file, optionally with a population mask and load rules" },
         { "save", (PyCFunction)PySession_save, METH_VARARGS, "Save the current stage to file" },
         { "copy", (PyCFunction)PySession_copy, METH_VARARGS, "Copy the current stage to file" },
         { "flatten", (PyCFunction)PySession_flatten, METH_VARARGS, "Flatten the stage to file" },
         { "flattenPaths", (PyCFunction)PySession_flattenPaths, METH_VARARGS, "Flatten specific paths to file" },
-        { "reload", (PyCFunction)PySession_reload, METH_NOARGS, "Reload the current stage" },
+        { "reload", (PyCFunction)PySession_reload, METH_VARARGS | METH_KEYWORDS,
+          "Reload the current stage, or only layers changed on disk" },
         { "close", (PyCFunction)PySession_close, METH_NOARGS, "Close the current stage" },
         { "isLoaded", (PyCFunction)PySession_isLoaded, METH_NOARGS, "Check if a stage is loaded" },
 
@@ -1085,11 +1103,52 @@ PyModule_getCurrentStage(PyObject*, PyObject*)
     return wrapUsdStage(s->stage());
 }
 
+static PyObject*
+PyModule_generateStage(PyObject*, PyObject* args, PyObject* kwargs)
+{
+    const char* filename = nullptr;
+    StageGenerator::Options options;
+    long long prims = options.prims;
+    unsigned int seed = options.seed;
+
+    static const char* keywords[] = { "filename",    "prims",    "depth",      "fanOut",   "payloadDensity",
+                                      "instanceRatio", "prototypes", "variantSets", "variants", "meshSize",
+                                      "seed",        nullptr };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|LiiddiiiiI", const_cast<char**>(keywords), &filename, &prims,
+                                     &options.depth, &options.fanOut, &options.payloadDensity, &options.instanceRatio,
+                                     &options.prototypes, &options.variantSets, &options.variants, &options.meshSize,
+                                     &seed))
+        return nullptr;
+
+    options.prims = prims;
+    options.seed = seed;
+
+    StageGenerator generator(options);
+    if (!generator.generate(QString::fromUtf8(filename))) {
+        PyErr_SetString(PyExc_RuntimeError, generator.error().toUtf8().constData());
+        return nullptr;
+    }
+
+    const StageGenerator::Statistics statistics = generator.statistics();
+    PyObject* layers = PyList_New(statistics.layers.size());
+    if (!layers)
+        return nullptr;
+    for (qsizetype i = 0; i < statistics.layers.size(); ++i)
+        PyList_SET_ITEM(layers, i, PyUnicode_FromString(statistics.layers[i].toUtf8().constData()));
+
+    return Py_BuildValue("{s:L,s:L,s:L,s:L,s:L,s:L,s:N}", "prims", (long long)statistics.prims, "groups",
+                         (long long)statistics.groups, "leaves", (long long)statistics.leaves, "meshes",
+                         (long long)statistics.meshes, "payloads", (long long)statistics.payloads, "instances",
+                         (long long)statistics.instances, "layers", layers);
+}
+
 static PyMethodDef Module_methods[]
     = { { "session", (PyCFunction)PyModule_session, METH_NOARGS, "Get the current usdviewer session wrapper" },
         { "selectionList", (PyCFunction)PyModule_selectionList, METH_NOARGS,
           "Get the current usdviewer selection list wrapper" },
         { "getCurrentStage", (PyCFunction)PyModule_getCurrentStage, METH_NOARGS, "Get the current native USD stage" },
+        { "generateStage", (PyCFunction)PyModule_generateStage, METH_VARARGS | METH_KEYWORDS,
+          "Write a synthetic stage for scale testing" },
         { nullptr, nullptr, 0, nullptr } };
 
 PyMODINIT_FUNC
@@ -245,7 +245,8 @@ using namespace usdviewer::qt;
 inline size_t
 qHash(const SdfPath& path, size_t seed = 0)
 {
-    return ::qHash(StringToQString(path.GetString()), seed);
+    // SdfPath hashes its interned path node, no string is built
+    return ::qHash(path.GetHash(), seed);
 }
 
 PXR_NAMESPACE_CLOSE_SCOPE
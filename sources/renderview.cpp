@@ -5,6 +5,7 @@
 #include "renderview.h"
 #include "application.h"
 #include "notice.h"
+#include "payloadstreamer.h"
 #include "usdutils.h"
 #include "viewcontext.h"
 #include <QPointer>
@@ -34,6 +35,7 @@ public Q_SLOTS:
 public:
     struct Data {
         QScopedPointer<ViewContext> context;
+        QScopedPointer<PayloadStreamer> streamer;
         QScopedPointer<Ui_RenderView> ui;
         QPointer<RenderView> view;
     };
@@ -48,7 +50,9 @@ RenderViewPrivate::init()
     d.context.reset(new ViewContext(d.view.data()));
     d.context->setStageLock(session()->stageLock());
     d.context->setCommandStack(session()->commandStack());
+    d.context->setStatisticsCache(session()->statisticsCache());
     imageGLWidget()->setContext(d.context.data());
+    d.streamer.reset(new PayloadStreamer());
     // connect
     connect(imageGLWidget(), &ImagingGLWidget::captureReady, this, &RenderViewPrivate::captureReady);
     connect(imageGLWidget(), &ImagingGLWidget::renderReady, this, &RenderViewPrivate::renderReady);
@@ -124,9 +128,11 @@ RenderViewPrivate::stageChanged(UsdStageRefPtr stage, Session::LoadPolicy policy
 {
     if (status == Session::StageStatus::Loaded) {
         imageGLWidget()->updateStage(session()->stage());
+        d.streamer->updateStage(stage, policy);
     }
     else {
         imageGLWidget()->close();
+        d.streamer->close();
     }
 }
 
@@ -140,6 +146,8 @@ RenderViewPrivate::captureReady(qint64 elapsed)
 void
 RenderViewPrivate::renderReady(qint64 elapsed)
 {
+    d.streamer->updateFrustum(camera().camera().GetFrustum());
+
     const qint64 thresholdMs = 500;
     if (elapsed > thresholdMs) {
         const QString msg = QStringLiteral("Render finished in %1 ms").arg(elapsed);
@@ -287,6 +295,18 @@ RenderView::setCameraAxisEnabled(bool enabled)
     p->imageGLWidget()->enableCameraAxis(enabled);
 }
 
+bool
+RenderView::payloadStreamingEnabled() const
+{
+    return p->d.streamer->isEnabled();
+}
+
+void
+RenderView::setPayloadStreamingEnabled(bool enabled)
+{
+    p->d.streamer->setEnabled(enabled);
+}
+
 void
 RenderView::captureVisible()
 {
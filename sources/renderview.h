@@ -194,6 +194,27 @@ public:
 
     ///@}
 
+    /** @name Payload Streaming */
+    ///@{
+
+    /**
+     * @brief Returns whether camera-driven payload streaming is enabled.
+     */
+    bool payloadStreamingEnabled() const;
+
+    /**
+     * @brief Enables or disables camera-driven payload streaming.
+     *
+     * Applies to stages opened with Session::LoadPolicy::None. Payloads
+     * are loaded in order of screen-space importance as the camera moves
+     * and unloaded after staying off-screen.
+     *
+     * @param enabled Streaming state.
+     */
+    void setPayloadStreamingEnabled(bool enabled);
+
+    ///@}
+
     /** @name Visible Capture */
     ///@{
 
@@ -3,22 +3,36 @@
 // https://github.com/mikaelsundell/usdviewer
 
 #include "session.h"
+#include "boundscache.h"
 #include "commandstack.h"
+#include "layerwatcher.h"
 #include "qtutils.h"
 #include "selectionlist.h"
+#include "stagecache.h"
+#include "statisticscache.h"
 #include "tracelocks.h"
 #include "usdutils.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QPointer>
+#include <QThreadPool>
+#include <QTimer>
 #include <pxr/base/tf/weakBase.h>
 #include <pxr/usd/usd/notice.h>
-#include <pxr/usd/usdGeom/bboxCache.h>
+#include <pxr/usd/usd/stageLoadRules.h>
+#include <pxr/usd/usd/stagePopulationMask.h>
 #include <pxr/usd/usdGeom/metrics.h>
 #include <pxr/usd/usdGeom/xform.h>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <stack>
 
 namespace usdviewer {
@@ -28,44 +42,96 @@ public:
     ~SessionPrivate();
     void init();
     void initStage();
-    void beginProgressBlock(const QString& name, size_t count);
+    void initStage(const GfBBox3d& bbox);
+    quint64 beginProgressBlock(const QString& name, size_t count);
     void updateProgressNotify(const Session::Notify& notify, size_t completed);
     void cancelProgressBlock();
     void endProgressBlock();
+    void endProgressBlock(quint64 block);
     bool isProgressBlockCancelled() const;
     bool newStage(Session::LoadPolicy policy);
-    bool loadFromFile(const QString& filename, Session::LoadPolicy loadPolicy);
-    bool mergeFromFile(const QString& filename);
+    bool loadFromFile(const QString& filename, Session::LoadPolicy loadPolicy, const Session::LoadOptions& options);
+    bool loadFromFileAsync(const QString& filename, Session::LoadPolicy loadPolicy,
+                           const Session::LoadOptions& options);
+    static UsdStageRefPtr openStage(StageCache* stageCache, const QString& key, const QString& filename,
+                                    Session::LoadPolicy loadPolicy, const Session::LoadOptions& options,
+                                    std::shared_ptr<BoundsCache>* bounds = nullptr);
+    static bool resetLoadState(const UsdStageRefPtr& stage, const QString& filename, Session::LoadPolicy loadPolicy,
+                               const Session::LoadOptions& options, BoundsCache* bounds);
+    static QString cacheKey(const QString& filename, Session::LoadPolicy loadPolicy,
+                            const Session::LoadOptions& options);
+    void retireStage();
+    static bool readLoadRules(const QString& filename, UsdStageLoadRules& rules);
+    bool mergeFromFile(const QString& filename, Session::LoadMode mode);
+    bool mergeFromFileAsync(const QString& filename);
+    bool mergeLayer(const QString& filename, const std::function<void(const Session::Notify&, size_t)>& notify,
+                    const std::function<bool()>& cancelled, bool& changed);
+    void finishMergeStage();
     bool saveToFile(const QString& filename);
     bool copyToFile(const QString& filename);
-    bool flattenPathsToFile(const QList<SdfPath>& paths, const QString& filename);
+    bool flattenPathsToFile(const QList<SdfPath>& paths, const QString& filename,
+                            const std::function<bool()>& cancelled = {});
+    int queueExport(const QString& filename, const QList<SdfPath>& paths);
+    void startExports();
+    void finishExport(const Session::ExportJob& job, bool exported, bool cancelled);
+    void cancelExports();
+    void endExports();
+    QList<Session::ExportJob> dropExports();
     bool loadState(const QString& filename);
+    static bool readState(const QString& filename, QList<SdfPath>& payloads);
+    static bool restoreState(const UsdStageRefPtr& stage, const QList<SdfPath>& payloads,
+                             const std::function<bool(size_t, size_t)>& progress = {});
     bool saveState(const QString& filename);
-    bool close();
+    bool close(bool cache = true);
     bool reload();
+    bool reloadChanged();
+    bool reloadLayers(const std::vector<SdfLayerHandle>& layers,
+                      const std::function<void(const Session::Notify&, size_t)>& notify,
+                      std::vector<SdfLayerHandle>& reloaded);
+    void refreshLayers();
+    void finishRefresh(const std::vector<SdfLayerHandle>& reloaded, quint64 generation, quint64 block);
+    void watchLayers();
+    void watchResyncedLayers(const NoticeBatch& batch);
+    std::vector<SdfLayerHandle> changedLayers() const;
+    void stampLayers(const std::vector<SdfLayerHandle>& layers);
     bool isLoaded() const;
+    bool isLoading() const;
+    void cancelLoad();
     void setMask(const QList<SdfPath>& paths);
     void setPayloads(const QList<SdfPath>& paths, bool loaded);
     Session::StageUp stageUp();
     void setStageUp(Session::StageUp stageUp);
     GfBBox3d boundingBox();
-    bool needsBoundingBoxUpdate(const NoticeBatch& batch) const;
+    void resetBounds(const std::shared_ptr<BoundsCache>& bounds);
+    void updateBounds();
+    void finishBounds(const GfBBox3d& bbox, bool valid, quint64 generation);
     void updatePrims(const NoticeBatch& batch);
     void flushPrims();
     void updateStage();
 
 public:
+    struct Node {
+        NoticeBatch batch;
+        Node* next = nullptr;
+    };
+
     class StageWatcher : public TfWeakBase {
     public:
         StageWatcher(SessionPrivate* parent)
-            : d { false, TfNotice::Key(), parent, UsdStageRefPtr() }
+            : d { parent }
         {}
 
+        ~StageWatcher()
+        {
+            init();
+        }
+
         void init()
         {
             if (d.key.IsValid())
                 TfNotice::Revoke(d.key);
             d.stage = nullptr;
+            discard(d.head.exchange(nullptr));
         }
 
         void watch(const UsdStageRefPtr& stage)
@@ -85,7 +151,8 @@ public:
             if (!d.stage || !senderStage || d.stage != senderStage)
                 return;
 
-            NoticeBatch batch;
+            Node* node = new Node();
+            NoticeBatch& batch = node->batch;
 
             for (const SdfPath& path : notice.GetChangedInfoOnlyPaths()) {
                 NoticeEntry entry;
@@ -110,24 +177,112 @@ public:
                 batch.entries.append(entry);
             }
 
-            if (batch.entries.isEmpty())
+            if (batch.entries.isEmpty()) {
+                delete node;
+                return;
+            }
+
+            d.received.fetch_add(1, std::memory_order_relaxed);
+            node->next = d.head.load(std::memory_order_relaxed);
+            while (!d.head.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {}
+
+            if (!d.scheduled.exchange(true, std::memory_order_acq_rel))
+                QMetaObject::invokeMethod(d.parent->d.session, [this]() { schedule(); }, Qt::QueuedConnection);
+        }
+
+        void schedule()
+        {
+            const qint64 elapsed = d.timer.isValid() ? d.timer.elapsed() : d.interval;
+            const int delay = int(qBound<qint64>(0, d.interval - elapsed, d.interval));
+            QTimer::singleShot(delay, Qt::PreciseTimer, d.parent->d.session, [this]() {
+                d.scheduled.store(false, std::memory_order_release);
+                dispatch();
+            });
+        }
+
+        void dispatch()
+        {
+            Node* head = d.head.exchange(nullptr, std::memory_order_acquire);
+            if (!head)
                 return;
 
-            QMetaObject::invokeMethod(d.parent->d.session, [this, batch]() { d.parent->updatePrims(batch); });
+            QList<Node*> nodes;
+            for (Node* node = head; node; node = node->next)
+                nodes.prepend(node);
+
+            NoticeCoalescer coalescer;
+            for (Node* node : nodes) {
+                coalescer.append(node->batch);
+                delete node;
+            }
+
+            d.merged.fetch_add(nodes.size() - 1, std::memory_order_relaxed);
+            d.delivered.fetch_add(1, std::memory_order_relaxed);
+            d.timer.start();
+            d.parent->updatePrims(coalescer.take());
+        }
+
+        void discard(Node* head)
+        {
+            while (head) {
+                Node* next = head->next;
+                delete head;
+                head = next;
+            }
+        }
+
+        void setInterval(int msecs) { d.interval = qMax(0, msecs); }
+        int interval() const { return d.interval; }
+
+        Session::NoticeStatistics statistics() const
+        {
+            Session::NoticeStatistics statistics;
+            statistics.received = d.received.load(std::memory_order_relaxed);
+            statistics.merged = d.merged.load(std::memory_order_relaxed);
+            statistics.delivered = d.delivered.load(std::memory_order_relaxed);
+            return statistics;
         }
 
         void blockSignals(bool block) { d.suppress.store(block); }
         bool signalsBlocked() const { return d.suppress.load(); }
 
         struct Data {
+            SessionPrivate* parent;
             std::atomic<bool> suppress { false };
+            std::atomic<bool> scheduled { false };
+            std::atomic<Node*> head { nullptr };
+            std::atomic<quint64> received { 0 };
+            std::atomic<quint64> merged { 0 };
+            std::atomic<quint64> delivered { 0 };
+            int interval = 16;
+            QElapsedTimer timer;
             TfNotice::Key key;
-            SessionPrivate* parent;
             UsdStageRefPtr stage;
         };
         Data d;
     };
 
+    // payloads loaded per LoadAndUnload when progress is reported
+    static constexpr size_t restoreChunkSize = 1024;
+
+    struct LoadJob {
+        std::atomic<bool> cancelled { false };
+    };
+
+    struct LoadResult {
+        UsdStageRefPtr stage;
+        QString filename;
+        Session::LoadPolicy loadPolicy = Session::LoadPolicy::All;
+        Session::LoadOptions loadOptions;
+        QString cacheKey;
+        GfBBox3d bbox;
+        std::shared_ptr<BoundsCache> bounds;
+        bool cancelled = false;
+    };
+    void endLoading();
+    void finishLoad(const LoadResult& result, quint64 generation);
+
     class StageBlocker {
     public:
         explicit StageBlocker(StageWatcher* w)
@@ -147,33 +302,72 @@ public:
         StageWatcher* watcher = nullptr;
     };
 
+    struct ExportTask {
+        Session::ExportJob job;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+
+    struct LayerStamp {
+        QDateTime modified;
+        qint64 size = -1;
+    };
+
     struct Data {
         UsdStageRefPtr stage;
         Session::LoadPolicy loadPolicy = Session::LoadPolicy::All;
+        Session::LoadOptions loadOptions;
         Session::PrimsUpdate primsUpdate = Session::PrimsUpdate::Immediate;
         Session::StageStatus stageStatus = Session::StageStatus::Closed;
 
         QString changeName;
         size_t changeDepth = 0;
+        quint64 blockGeneration = 0;
         size_t expectedChanges = 0;
         size_t completedChanges = 0;
         std::atomic<bool> changeCancelled { false };
 
+        std::shared_ptr<LoadJob> loadJob;
+        std::atomic<quint64> loadGeneration { 0 };
+
         QString filename;
+        QString cacheKey;
         GfBBox3d bbox;
-        NoticeBatch pendingNotices;
+        std::shared_ptr<BoundsCache> bounds;
+        bool boundsRunning = false;
+        bool boundsQueued = false;
+        quint64 boundsGeneration = 0;
+        NoticeCoalescer pendingNotices;
         QList<SdfPath> mask;
+        QHash<QString, LayerStamp> layerStamps;
+        QDateTime layerStampTime;
+        QList<ExportTask> exportQueue;
+        int exportsRunning = 0;
+        int exportConcurrency = 2;
+        int exportId = 0;
+        size_t exportsExpected = 0;
+        size_t exportsCompleted = 0;
+        QHash<int, std::shared_ptr<std::atomic<bool>>> exportsActive;
+        bool autoRefresh = false;
+        bool refreshQueued = false;
 
         mutable QReadWriteLock stageLock;
         QScopedPointer<CommandStack> commandStack;
         QScopedPointer<SelectionList> selectionList;
         QScopedPointer<StageWatcher> stageWatcher;
+        QScopedPointer<LayerWatcher> layerWatcher;
+        std::shared_ptr<StageCache> stageCache;
+        QScopedPointer<StatisticsCache> statisticsCache;
         QPointer<Session> session;
     };
     Data d;
 };
 
-SessionPrivate::SessionPrivate() { d.stageWatcher.reset(new StageWatcher(this)); }
+SessionPrivate::SessionPrivate()
+{
+    d.stageWatcher.reset(new StageWatcher(this));
+    d.stageCache.reset(new StageCache());
+    d.bounds = std::make_shared<BoundsCache>();
+}
 
 SessionPrivate::~SessionPrivate() = default;
 
@@ -185,14 +379,22 @@ SessionPrivate::init()
 
     d.commandStack.reset(new CommandStack());
     d.selectionList.reset(new SelectionList());
+    d.statisticsCache.reset(new StatisticsCache());
+    d.layerWatcher.reset(new LayerWatcher());
+    QObject::connect(d.layerWatcher.data(), &LayerWatcher::filesChanged, d.session, [this]() { refreshLayers(); });
 }
 
 void
 SessionPrivate::initStage()
 {
-    UsdStageRefPtr stage;
-    const GfBBox3d bbox = boundingBox();
+    resetBounds(std::make_shared<BoundsCache>());
+    initStage(boundingBox());
+}
 
+void
+SessionPrivate::initStage(const GfBBox3d& bbox)
+{
+    UsdStageRefPtr stage;
     {
         READ_LOCKER(locker, &d.stageLock, "stageLock");
         stage = d.stage;
@@ -202,23 +404,32 @@ SessionPrivate::initStage()
         WRITE_LOCKER(locker, &d.stageLock, "stageLock");
         d.stageStatus = Session::StageStatus::Loaded;
         d.bbox = bbox;
-        d.pendingNotices.entries.clear();
+        d.pendingNotices.clear();
+        d.layerStamps.clear();
+        if (d.stage) {
+            const SdfLayerHandleVector layers = d.stage->GetUsedLayers(true);
+            stampLayers(std::vector<SdfLayerHandle>(layers.begin(), layers.end()));
+        }
+        d.layerStampTime = QDateTime::currentDateTime();
     }
 
     d.stageWatcher->watch(stage);
+    watchLayers();
 }
 
-void
+quint64
 SessionPrivate::beginProgressBlock(const QString& name, size_t count)
 {
-    d.changeCancelled.store(false);
     d.changeName = name;
     d.changeDepth++;
     if (d.changeDepth == 1) {
+        // a nested block never clears a pending cancel of the block it runs in
+        d.changeCancelled.store(false);
         d.expectedChanges = count;
         d.completedChanges = 0;
         Q_EMIT d.session->progressBlockChanged(name, Session::ProgressMode::Running);
     }
+    return d.blockGeneration;
 }
 
 void
@@ -240,6 +451,9 @@ SessionPrivate::endProgressBlock()
     if (d.changeDepth == 0)
         return;
 
+    if (d.changeDepth == 1)
+        d.stageWatcher->dispatch();
+
     d.changeDepth--;
     if (d.changeDepth > 0)
         return;
@@ -251,16 +465,30 @@ SessionPrivate::endProgressBlock()
     d.changeName.clear();
 
     if (cancelled) {
-        d.pendingNotices.entries.clear();
+        const QList<SdfPath> paths = BoundsCache::changedPaths(d.pendingNotices.take());
+        if (!paths.isEmpty()) {
+            d.bounds->invalidate(paths);
+            updateBounds();
+        }
         return;
     }
 
-    if (d.pendingNotices.entries.isEmpty())
+    if (d.pendingNotices.isEmpty())
         return;
 
     flushPrims();
 }
 
+void
+SessionPrivate::endProgressBlock(quint64 block)
+{
+    // blocks begun before close() was called are already gone
+    if (block != d.blockGeneration)
+        return;
+
+    endProgressBlock();
+}
+
 bool
 SessionPrivate::isProgressBlockCancelled() const
 {
@@ -290,9 +518,11 @@ SessionPrivate::newStage(Session::LoadPolicy policy)
         UsdGeomXform root = UsdGeomXform::Define(d.stage, SdfPath("/World"));
         d.stage->SetDefaultPrim(root.GetPrim());
         d.filename.clear();
+        d.cacheKey.clear();
         d.loadPolicy = policy;
+        d.loadOptions = Session::LoadOptions();
         d.mask.clear();
-        d.pendingNotices.entries.clear();
+        d.pendingNotices.clear();
         mask = d.mask;
         created = true;
     }
@@ -310,23 +540,28 @@ SessionPrivate::newStage(Session::LoadPolicy policy)
 }
 
 bool
-SessionPrivate::loadFromFile(const QString& filename, Session::LoadPolicy policy)
+SessionPrivate::loadFromFile(const QString& filename, Session::LoadPolicy policy, const Session::LoadOptions& options)
 {
+    d.loadGeneration++;  // supersede any background load
+    endLoading();
+    cancelExports();
+
     QList<SdfPath> mask;
+    std::shared_ptr<BoundsCache> cachedBounds;
     bool loaded = false;
     {
         WRITE_LOCKER(locker, &d.stageLock, "stageLock");
         StageBlocker blocker(d.stageWatcher.data());
         d.stageWatcher->init();
+        retireStage();
 
-        if (policy == Session::LoadPolicy::All)
-            d.stage = UsdStage::Open(QStringToString(filename), UsdStage::LoadAll);
-        else
-            d.stage = UsdStage::Open(QStringToString(filename), UsdStage::LoadNone);
-
+        const QString key = cacheKey(filename, policy, options);
+        d.stage = openStage(d.stageCache.get(), key, filename, policy, options, &cachedBounds);
+        d.cacheKey = d.stage ? key : QString();
         d.loadPolicy = policy;
+        d.loadOptions = options;
         d.mask.clear();
-        d.pendingNotices.entries.clear();
+        d.pendingNotices.clear();
 
         if (d.stage) {
             d.filename = QFileInfo(filename).absoluteFilePath();
@@ -347,6 +582,7 @@ SessionPrivate::loadFromFile(const QString& filename, Session::LoadPolicy policy
             d.stage = nullptr;
             d.stageStatus = Session::StageStatus::Failed;
             d.filename.clear();
+            d.cacheKey.clear();
             return false;
         }
     }
@@ -354,8 +590,13 @@ SessionPrivate::loadFromFile(const QString& filename, Session::LoadPolicy policy
     d.commandStack->clear();
     d.selectionList->clear();
 
-    if (loaded)
+    if (loaded && cachedBounds) {
+        resetBounds(cachedBounds);
+        initStage(boundingBox());
+    }
+    else if (loaded) {
         initStage();
+    }
 
     setMask(mask);
     updateStage();
@@ -363,86 +604,491 @@ SessionPrivate::loadFromFile(const QString& filename, Session::LoadPolicy policy
 }
 
 bool
-SessionPrivate::mergeFromFile(const QString& filename)
+SessionPrivate::loadFromFileAsync(const QString& filename, Session::LoadPolicy policy,
+                                  const Session::LoadOptions& options)
 {
-    const QString absFilename = QFileInfo(filename).absoluteFilePath();
-    if (absFilename.endsWith(".session", Qt::CaseInsensitive)) {
-        QFile file(absFilename);
-        if (!file.exists())
-            return false;
-        if (!file.open(QIODevice::ReadOnly))
-            return false;
+    const quint64 generation = ++d.loadGeneration;
+    const QPointer<Session> session = d.session;
+    if (!session)
+        return false;
 
-        const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-        if (!doc.isObject())
-            return false;
+    // the load has its own progress and cancel state, progress blocks begun or cancelled
+    // meanwhile never touch it and notices on the current stage are not deferred
+    endLoading();
+    const std::shared_ptr<LoadJob> job = std::make_shared<LoadJob>();
+    const std::shared_ptr<StageCache> stageCache = d.stageCache;
+    d.loadJob = job;
+    Q_EMIT d.session->progressBlockChanged("open stage", Session::ProgressMode::Running);
+
+    // the worker only uses the job and the stage cache, this is used by queued
+    // calls on the gui thread once the session is known to be alive
+    QThreadPool::globalInstance()->start([this, session, job, stageCache, filename, policy, options, generation]() {
+        auto notify = [this, session, generation](const Session::Notify& notify, size_t completed, size_t expected) {
+            QMetaObject::invokeMethod(
+                QCoreApplication::instance(),
+                [this, session, notify, completed, expected, generation]() {
+                    if (session && generation == d.loadGeneration.load())
+                        Q_EMIT d.session->progressNotifyChanged(notify, completed, expected);
+                },
+                Qt::QueuedConnection);
+        };
+        auto cancelled = [job]() { return job->cancelled.load(); };
+
+        LoadResult result;
+        result.filename = filename;
+        result.loadPolicy = policy;
+        result.loadOptions = options;
+        result.cacheKey = cacheKey(filename, policy, options);
+        result.stage = openStage(stageCache.get(), result.cacheKey, filename, policy, options, &result.bounds);
+
+        // open, one step per restored payload chunk and bounds
+        size_t step = 0;
+        size_t expected = 3;
+        if (!result.stage) {
+            notify(Session::Notify("stage failed", {}, Session::Notify::Status::Error), ++step, expected);
+        }
+        else {
+            notify(Session::Notify("stage opened", { SdfPath::AbsoluteRootPath() }), ++step, expected);
+
+            if (!cancelled() && policy == Session::LoadPolicy::None) {
+                const QString absFilename = QFileInfo(filename).absoluteFilePath();
+                QList<SdfPath> payloads;
+                if (!readState(QFileInfo(absFilename + ".session").absoluteFilePath(), payloads)) {
+                    result.stage = nullptr;
+                    notify(Session::Notify("session state failed", {}, Session::Notify::Status::Error), ++step,
+                           expected);
+                }
+                else {
+                    restoreState(result.stage, payloads, [&](size_t completed, size_t total) {
+                        if (completed == 0) {
+                            expected = step + (total + restoreChunkSize - 1) / restoreChunkSize + 1;
+                            return !cancelled();
+                        }
+                        notify(Session::Notify(QString("payloads restored %1/%2").arg(completed).arg(total), payloads),
+                               ++step, expected);
+                        return !cancelled();
+                    });
+                }
+            }
+
+            // bounds are computed before the stage is published, the gui
+            // thread only swaps the stage in
+            if (result.stage && !cancelled()) {
+                if (!result.bounds)
+                    result.bounds = std::make_shared<BoundsCache>();
+                result.bbox = result.bounds->compute(result.stage);
+                notify(Session::Notify("bounds computed", { SdfPath::AbsoluteRootPath() }), ++step, expected);
+            }
+        }
 
-        const QJsonObject root = doc.object();
-        const QJsonArray payloads = root.value("loadedPayloads").toArray();
+        result.cancelled = cancelled();
+        if (result.cancelled)
+            result.stage = nullptr;
+
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [this, session, result, generation]() {
+                if (session)
+                    finishLoad(result, generation);
+            },
+            Qt::QueuedConnection);
+    });
+    return true;
+}
 
-        WRITE_LOCKER(locker, &d.stageLock, "stageLock");
-        if (!d.stage)
-            return false;
+void
+SessionPrivate::cancelLoad()
+{
+    if (d.loadJob)
+        d.loadJob->cancelled.store(true);
+}
+
+void
+SessionPrivate::endLoading()
+{
+    if (!d.loadJob)
+        return;
+
+    // a superseded or closed load stops at its next step
+    d.loadJob->cancelled.store(true);
+    d.loadJob.reset();
+    Q_EMIT d.session->progressBlockChanged("open stage", Session::ProgressMode::Idle);
+}
+
+void
+SessionPrivate::finishLoad(const LoadResult& result, quint64 generation)
+{
+    if (generation != d.loadGeneration.load())
+        return;
 
+    endLoading();
+    if (!result.stage) {
+        // a failed open replaces the stage like the blocking load, a cancelled one keeps it
+        if (!result.cancelled) {
+            cancelExports();
+            {
+                WRITE_LOCKER(locker, &d.stageLock, "stageLock");
+                StageBlocker blocker(d.stageWatcher.data());
+                d.stageWatcher->init();
+                retireStage();
+                d.stage = nullptr;
+                d.cacheKey.clear();
+                d.stageStatus = Session::StageStatus::Failed;
+                d.filename.clear();
+                d.pendingNotices.clear();
+            }
+            d.commandStack->clear();
+            d.selectionList->clear();
+            updateStage();
+        }
+        Q_EMIT d.session->loadFinished(result.filename, false, result.cancelled);
+        return;
+    }
+
+    // exports of the replaced stage are cancelled
+    cancelExports();
+
+    QList<SdfPath> mask;
+    {
+        WRITE_LOCKER(locker, &d.stageLock, "stageLock");
         StageBlocker blocker(d.stageWatcher.data());
+        d.stageWatcher->init();
+        retireStage();
 
-        for (const QJsonValue& value : payloads) {
-            const QString pathString = value.toString().trimmed();
-            if (pathString.isEmpty())
-                continue;
+        d.stage = result.stage;
+        d.cacheKey = result.cacheKey;
+        d.loadPolicy = result.loadPolicy;
+        d.loadOptions = result.loadOptions;
+        d.filename = QFileInfo(result.filename).absoluteFilePath();
+        d.mask.clear();
+        d.pendingNotices.clear();
+        mask = d.mask;
+    }
 
-            const SdfPath path(qt::QStringToString(pathString));
-            if (!path.IsAbsolutePath())
-                continue;
+    d.commandStack->clear();
+    d.selectionList->clear();
 
-            const UsdPrim prim = d.stage->GetPrimAtPath(path);
-            if (!prim || !prim.IsValid())
-                continue;
+    resetBounds(result.bounds);
+    initStage(result.bbox);
+    setMask(mask);
+    updateStage();
+    Q_EMIT d.session->loadFinished(result.filename, true, false);
+}
 
-            if (!stage::isPayload(d.stage, path))
-                continue;
+UsdStageRefPtr
+SessionPrivate::openStage(StageCache* stageCache, const QString& key, const QString& filename,
+                          Session::LoadPolicy policy, const Session::LoadOptions& options,
+                          std::shared_ptr<BoundsCache>* bounds)
+{
+    std::shared_ptr<BoundsCache> cachedBounds;
+    if (UsdStageRefPtr stage = stageCache->take(key, &cachedBounds)) {
+        try {
+            if (resetLoadState(stage, filename, policy, options, cachedBounds.get())) {
+                if (bounds)
+                    *bounds = cachedBounds;
+                return stage;
+            }
+        } catch (const std::exception&) {
+        }
+        return nullptr;
+    }
 
-            if (!prim.IsLoaded())
-                prim.Load();
+    try {
+        if (options.isEmpty()) {
+            return UsdStage::Open(QStringToString(filename),
+                                  policy == Session::LoadPolicy::All ? UsdStage::LoadAll : UsdStage::LoadNone);
+        }
+
+        UsdStageLoadRules rules = (policy == Session::LoadPolicy::All) ? UsdStageLoadRules::LoadAll()
+                                                                        : UsdStageLoadRules::LoadNone();
+        if (!options.loadRules.isEmpty() && !readLoadRules(options.loadRules, rules))
+            return nullptr;
+
+        const SdfLayerRefPtr rootLayer = SdfLayer::FindOrOpen(QStringToString(filename));
+        if (!rootLayer)
+            return nullptr;
+
+        UsdStagePopulationMask mask = UsdStagePopulationMask::All();
+        if (!options.mask.isEmpty()) {
+            mask = UsdStagePopulationMask();
+            for (const SdfPath& path : path::topLevelPaths(options.mask))
+                mask.Add(path);
         }
 
+        // open unloaded and apply the rules once, payloads are composed in a single pass
+        UsdStageRefPtr stage = UsdStage::OpenMasked(rootLayer, mask, UsdStage::LoadNone);
+        if (stage)
+            stage->SetLoadRules(rules);
+        return stage;
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+bool
+SessionPrivate::resetLoadState(const UsdStageRefPtr& stage, const QString& filename, Session::LoadPolicy policy,
+                               const Session::LoadOptions& options, BoundsCache* bounds)
+{
+    // a cached stage keeps the payloads loaded and unloaded while it was open,
+    // reset them to the rules file and .session a fresh open applies
+    UsdStageLoadRules rules = (policy == Session::LoadPolicy::All) ? UsdStageLoadRules::LoadAll()
+                                                                    : UsdStageLoadRules::LoadNone();
+    if (!options.loadRules.isEmpty() && !readLoadRules(options.loadRules, rules))
+        return false;
+
+    if (policy == Session::LoadPolicy::None) {
+        const QString absFilename = QFileInfo(filename).absoluteFilePath();
+        QList<SdfPath> payloads;
+        if (!readState(QFileInfo(absFilename + ".session").absoluteFilePath(), payloads))
+            return false;
+
+        for (const SdfPath& path : payloads) {
+            // same paths restoreState() loads, nested payloads come with their parent
+            const UsdPrim prim = stage->GetPrimAtPath(path);
+            if (prim && prim.IsValid() && stage::isPayload(stage, path))
+                rules.AddRule(path, UsdStageLoadRules::AllRule);
+        }
+        rules.Minimize();
+    }
+
+    const SdfPathSet loaded = stage->GetLoadSet();
+    stage->SetLoadRules(rules);
+    if (!bounds)
         return true;
+
+    // only the payloads that changed state lose their cached bounds
+    const SdfPathSet reloaded = stage->GetLoadSet();
+    QList<SdfPath> changed;
+    std::set_symmetric_difference(loaded.begin(), loaded.end(), reloaded.begin(), reloaded.end(),
+                                  std::back_inserter(changed));
+    if (!changed.isEmpty())
+        bounds->invalidate(changed);
+    return true;
+}
+
+QString
+SessionPrivate::cacheKey(const QString& filename, Session::LoadPolicy policy, const Session::LoadOptions& options)
+{
+    QStringList mask;
+    for (const SdfPath& path : options.mask)
+        mask.append(StringToQString(path.GetString()));
+
+    // the rules file is keyed by its stamp, an edited file never serves a stage opened with the old rules
+    QString loadRules;
+    if (!options.loadRules.isEmpty()) {
+        const QFileInfo info(options.loadRules);
+        loadRules = QString("%1@%2:%3")
+                        .arg(info.absoluteFilePath())
+                        .arg(info.lastModified().toMSecsSinceEpoch())
+                        .arg(info.size());
     }
+    return StageCache::key(filename, QString("%1|%2|%3").arg(int(policy)).arg(mask.join(',')).arg(loadRules));
+}
 
-    UsdStageRefPtr sourceStage;
-    try {
-        sourceStage = UsdStage::Open(QStringToString(absFilename), UsdStage::LoadAll);
-    } catch (const std::exception&) {
+void
+SessionPrivate::retireStage()
+{
+    // called with the stage lock held, keeps the released stage warm under the key it was opened with
+    if (!d.stage || d.cacheKey.isEmpty())
+        return;
+
+    const SdfLayerHandle rootLayer = d.stage->GetRootLayer();
+    if (!rootLayer || rootLayer->IsAnonymous() || rootLayer->GetRealPath().empty())
+        return;
+
+    d.stageCache->insert(d.cacheKey, d.stage, d.bounds);
+}
+
+bool
+SessionPrivate::readLoadRules(const QString& filename, UsdStageLoadRules& rules)
+{
+    QFile file(QFileInfo(filename).absoluteFilePath());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject())
         return false;
+
+    const QJsonObject root = doc.object();
+    if (root.contains("loadedPayloads")) {
+        for (const QJsonValue& value : root.value("loadedPayloads").toArray()) {
+            const SdfPath path(qt::QStringToString(value.toString().trimmed()));
+            if (path.IsAbsolutePath() && path.IsPrimPath())
+                rules.AddRule(path, UsdStageLoadRules::AllRule);
+        }
+    }
+
+    for (const QJsonValue& value : root.value("rules").toArray()) {
+        const QJsonObject object = value.toObject();
+        const SdfPath path(qt::QStringToString(object.value("path").toString().trimmed()));
+        if (!path.IsAbsolutePath() || !(path.IsPrimPath() || path.IsAbsoluteRootPath()))
+            continue;
+
+        const QString rule = object.value("rule").toString().toLower();
+        if (rule == "all")
+            rules.AddRule(path, UsdStageLoadRules::AllRule);
+        else if (rule == "only")
+            rules.AddRule(path, UsdStageLoadRules::OnlyRule);
+        else if (rule == "none")
+            rules.AddRule(path, UsdStageLoadRules::NoneRule);
     }
 
-    if (!sourceStage)
+    rules.Minimize();
+    return true;
+}
+
+bool
+SessionPrivate::mergeFromFile(const QString& filename, Session::LoadMode mode)
+{
+    const QString absFilename = QFileInfo(filename).absoluteFilePath();
+    if (mode == Session::LoadMode::Background)
+        return mergeFromFileAsync(absFilename);
+
+    beginProgressBlock("merge file", 3);
+    bool changed = false;
+    const bool merged = mergeLayer(
+        absFilename, [this](const Session::Notify& notify, size_t completed) { updateProgressNotify(notify, completed); },
+        [this]() { return isProgressBlockCancelled(); }, changed);
+    endProgressBlock();
+
+    if (changed)
+        finishMergeStage();
+    return merged;
+}
+
+bool
+SessionPrivate::mergeFromFileAsync(const QString& filename)
+{
+    const quint64 generation = d.loadGeneration.load();
+    const QPointer<Session> session = d.session;
+    if (!session)
         return false;
 
-    {
-        WRITE_LOCKER(locker, &d.stageLock, "stageLock");
-        if (!d.stage)
-            return false;
+    const quint64 block = beginProgressBlock("merge file", 3);
 
-        StageBlocker blocker(d.stageWatcher.data());
-        const SdfLayerHandle destRoot = d.stage->GetRootLayer();
-        const SdfLayerHandle srcRoot = sourceStage->GetRootLayer();
+    QThreadPool::globalInstance()->start([this, session, filename, generation, block]() {
+        auto notify = [this, session, generation](const Session::Notify& notify, size_t completed) {
+            if (!session)
+                return;
+            QMetaObject::invokeMethod(
+                session,
+                [this, notify, completed, generation]() {
+                    if (generation == d.loadGeneration.load())
+                        updateProgressNotify(notify, completed);
+                },
+                Qt::QueuedConnection);
+        };
+        auto cancelled = [this, generation]() {
+            return isProgressBlockCancelled() || generation != d.loadGeneration.load();
+        };
+
+        bool changed = false;
+        const bool merged = mergeLayer(filename, notify, cancelled, changed);
+        const bool wasCancelled = cancelled();
+
+        if (!session)
+            return;
+
+        QMetaObject::invokeMethod(
+            session,
+            [this, filename, merged, changed, wasCancelled, generation, block]() {
+                // after close() the merge block is gone, never end another operation's block
+                endProgressBlock(block);
+                if (generation != d.loadGeneration.load())
+                    return;
+                if (changed)
+                    finishMergeStage();
+                Q_EMIT d.session->mergeFinished(filename, merged, wasCancelled);
+            },
+            Qt::QueuedConnection);
+    });
+    return true;
+}
+
+bool
+SessionPrivate::mergeLayer(const QString& filename, const std::function<void(const Session::Notify&, size_t)>& notify,
+                           const std::function<bool()>& cancelled, bool& changed)
+{
+    changed = false;
+    const bool isSession = filename.endsWith(".session", Qt::CaseInsensitive);
+    const QString sessionFilename = isSession ? filename : QFileInfo(filename + ".session").absoluteFilePath();
+
+    if (!isSession) {
+        // only the layer is opened, the source is never composed on its own
+        SdfLayerRefPtr layer;
+        try {
+            layer = SdfLayer::FindOrOpen(QStringToString(filename));
+        } catch (const std::exception&) {
+            layer = nullptr;
+        }
 
-        if (!destRoot || !srcRoot)
+        if (!layer) {
+            notify(Session::Notify("layer failed", {}, Session::Notify::Status::Error), 1);
             return false;
+        }
+        notify(Session::Notify(QString("layer opened: %1").arg(filename)), 1);
 
-        const std::string srcIdentifier = srcRoot->GetIdentifier();
-        const auto& sublayers = destRoot->GetSubLayerPaths();
-        if (std::find(sublayers.begin(), sublayers.end(), srcIdentifier) == sublayers.end()) {
-            destRoot->GetSubLayerPaths().push_back(srcIdentifier);
+        if (cancelled())
+            return false;
+
+        {
+            WRITE_LOCKER(locker, &d.stageLock, "stageLock");
+            if (!d.stage)
+                return false;
+
+            StageBlocker blocker(d.stageWatcher.data());
+            const SdfLayerHandle destRoot = d.stage->GetRootLayer();
+            if (!destRoot)
+                return false;
+
+            const std::string identifier = layer->GetIdentifier();
+            const auto& sublayers = destRoot->GetSubLayerPaths();
+            if (std::find(sublayers.begin(), sublayers.end(), identifier) == sublayers.end()) {
+                destRoot->GetSubLayerPaths().push_back(identifier);
+                d.bounds->clear();
+                changed = true;
+            }
         }
+        notify(Session::Notify("layer merged", { SdfPath::AbsoluteRootPath() }), 2);
     }
-    const QString sessionFilename = QFileInfo(absFilename + ".session").absoluteFilePath();
-    QFile sessionFile(sessionFilename);
-    if (sessionFile.exists()) {
-        mergeFromFile(sessionFilename);
+
+    if (!QFileInfo::exists(sessionFilename)) {
+        if (isSession)
+            return false;
+
+        notify(Session::Notify("layer merged"), 3);
+        return true;
     }
-    return true;
+
+    if (cancelled())
+        return false;
+
+    QList<SdfPath> payloads;
+    if (!readState(sessionFilename, payloads)) {
+        notify(Session::Notify("session state failed", {}, Session::Notify::Status::Error), 3);
+        return false;
+    }
+
+    WRITE_LOCKER(locker, &d.stageLock, "stageLock");
+    if (!d.stage)
+        return false;
+
+    StageBlocker blocker(d.stageWatcher.data());
+    d.bounds->invalidate(payloads);
+    return restoreState(d.stage, payloads, [&](size_t completed, size_t total) {
+        notify(Session::Notify(QString("payloads restored %1/%2").arg(completed).arg(total), payloads), 3);
+        return !cancelled();
+    });
+}
+
+void
+SessionPrivate::finishMergeStage()
+{
+    // sublayer edits are applied with notices blocked, publish the
+    // recomposed stage as a whole
+    updateBounds();
+    updateStage();
 }
 
 bool
@@ -450,6 +1096,7 @@ SessionPrivate::saveToFile(const QString& filename)
 {
     QString stageFilename;
     Session::LoadPolicy loadPolicy = Session::LoadPolicy::All;
+    Session::LoadOptions loadOptions;
     bool saveAs = false;
 
     {
@@ -469,10 +1116,13 @@ SessionPrivate::saveToFile(const QString& filename)
                 currentFile = QFileInfo(qt::StringToQString(rootLayer->GetRealPath())).absoluteFilePath();
 
             loadPolicy = d.loadPolicy;
+            loadOptions = d.loadOptions;
 
             if (!rootLayer->IsAnonymous() && currentFile == stageFilename) {
                 d.stage->Save();
                 d.filename = stageFilename;
+                const SdfLayerHandleVector layers = d.stage->GetUsedLayers(true);
+                stampLayers(std::vector<SdfLayerHandle>(layers.begin(), layers.end()));
                 return true;
             }
 
@@ -495,8 +1145,9 @@ SessionPrivate::saveToFile(const QString& filename)
     if (!saveAs)
         return true;
 
-    close();
-    return loadFromFile(stageFilename, loadPolicy);
+    // the exported file is read back, the stage it was exported from is not kept
+    close(false);
+    return loadFromFile(stageFilename, loadPolicy, loadOptions);
 }
 bool
 SessionPrivate::copyToFile(const QString& filename)
@@ -534,31 +1185,185 @@ SessionPrivate::copyToFile(const QString& filename)
 }
 
 bool
-SessionPrivate::flattenPathsToFile(const QList<SdfPath>& paths, const QString& filename)
+SessionPrivate::flattenPathsToFile(const QList<SdfPath>& paths, const QString& filename,
+                                   const std::function<bool()>& cancelled)
 {
-    READ_LOCKER(locker, &d.stageLock, "stageLock");
-    if (!d.stage)
-        return false;
+    // the stage lock is only held while flattening into an in-memory layer,
+    // writing the layer to disk runs unlocked so writers and rendering are
+    // not held back by file io
+    SdfLayerRefPtr layer;
+    try {
+        READ_LOCKER(locker, &d.stageLock, "stageLock");
+        if (!d.stage)
+            return false;
+
+        if (paths.isEmpty()) {
+            layer = d.stage->Flatten();
+        }
+        else {
+            UsdStagePopulationMask mask;
+            const QList<SdfPath> roots = path::topLevelPaths(paths);
+            for (const SdfPath& path : roots)
+                mask.Add(path);
+
+            if (mask.GetPaths().empty())
+                return false;
+
+            UsdStageRefPtr maskedStage = UsdStage::OpenMasked(d.stage->GetRootLayer(), mask);
+            if (!maskedStage)
+                return false;
 
-    UsdStagePopulationMask mask;
-    const QList<SdfPath> roots = path::topLevelPaths(paths);
-    for (const SdfPath& path : roots)
-        mask.Add(path);
+            maskedStage->ExpandPopulationMask();
+            layer = maskedStage->Flatten();
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
 
-    if (mask.GetPaths().empty())
+    if (!layer || (cancelled && cancelled()))
         return false;
 
-    UsdStageRefPtr maskedStage = UsdStage::OpenMasked(d.stage->GetRootLayer(), mask);
-    if (!maskedStage)
+    try {
+        return layer->Export(QStringToString(QFileInfo(filename).absoluteFilePath()));
+    } catch (const std::exception&) {
         return false;
+    }
+}
+
+int
+SessionPrivate::queueExport(const QString& filename, const QList<SdfPath>& paths)
+{
+    if (!isLoaded())
+        return 0;
+
+    ExportTask task;
+    task.job.id = ++d.exportId;
+    task.job.filename = QFileInfo(filename).absoluteFilePath();
+    task.job.paths = paths;
+    task.cancelled = std::make_shared<std::atomic<bool>>(false);
+
+    // exports are read-only, they report progress on their own and never hold a
+    // progress block, so stage notices and layer refreshes are not deferred
+    if (d.exportsExpected == 0) {
+        d.exportsCompleted = 0;
+        Q_EMIT d.session->progressBlockChanged("export", Session::ProgressMode::Running);
+    }
+    d.exportsExpected++;
 
-    maskedStage->ExpandPopulationMask();
-    return maskedStage->Export(QStringToString(QFileInfo(filename).absoluteFilePath()));
+    d.exportQueue.append(task);
+    startExports();
+    return task.job.id;
+}
+
+void
+SessionPrivate::startExports()
+{
+    const QPointer<Session> session = d.session;
+    while (d.exportsRunning < d.exportConcurrency && !d.exportQueue.isEmpty()) {
+        const ExportTask task = d.exportQueue.takeFirst();
+        const Session::ExportJob job = task.job;
+        const std::shared_ptr<std::atomic<bool>> cancelled = task.cancelled;
+        d.exportsActive.insert(job.id, cancelled);
+        d.exportsRunning++;
+
+        QThreadPool::globalInstance()->start([this, session, job, cancelled]() {
+            auto isCancelled = [cancelled]() { return cancelled->load(); };
+            const bool exported = !isCancelled() && flattenPathsToFile(job.paths, job.filename, isCancelled);
+            const bool wasCancelled = !exported && isCancelled();
+
+            QMetaObject::invokeMethod(
+                QCoreApplication::instance(),
+                [this, session, job, exported, wasCancelled]() {
+                    if (session)
+                        finishExport(job, exported, wasCancelled);
+                },
+                Qt::QueuedConnection);
+        });
+    }
+}
+
+void
+SessionPrivate::finishExport(const Session::ExportJob& job, bool exported, bool cancelled)
+{
+    d.exportsRunning--;
+    d.exportsCompleted++;
+    d.exportsActive.remove(job.id);
+
+    const QString message = exported    ? QString("exported: %1").arg(job.filename)
+                            : cancelled ? QString("export cancelled: %1").arg(job.filename)
+                                        : QString("export failed: %1").arg(job.filename);
+    const Session::Notify::Status status = exported    ? Session::Notify::Status::Progress
+                                           : cancelled ? Session::Notify::Status::Warning
+                                                       : Session::Notify::Status::Error;
+    Q_EMIT d.session->progressNotifyChanged(Session::Notify(message, job.paths, status), d.exportsCompleted,
+                                            d.exportsExpected);
+    Q_EMIT d.session->exportFinished(job.id, job.filename, exported, cancelled);
+
+    if (cancelled)
+        dropExports();
+
+    if (d.exportsRunning == 0 && d.exportQueue.isEmpty()) {
+        endExports();
+        return;
+    }
+    startExports();
+}
+
+void
+SessionPrivate::cancelExports()
+{
+    dropExports();
+    for (const std::shared_ptr<std::atomic<bool>>& cancelled : std::as_const(d.exportsActive))
+        cancelled->store(true);
+
+    // running exports end the channel as they finish
+    if (d.exportsRunning == 0)
+        endExports();
+}
+
+void
+SessionPrivate::endExports()
+{
+    if (d.exportsExpected == 0)
+        return;
+
+    d.exportsExpected = 0;
+    d.exportsCompleted = 0;
+    Q_EMIT d.session->progressBlockChanged("export", Session::ProgressMode::Idle);
+}
+
+QList<Session::ExportJob>
+SessionPrivate::dropExports()
+{
+    QList<Session::ExportJob> jobs;
+    for (const ExportTask& task : std::as_const(d.exportQueue))
+        jobs.append(task.job);
+    d.exportQueue.clear();
+
+    for (const Session::ExportJob& job : jobs)
+        Q_EMIT d.session->exportFinished(job.id, job.filename, false, true);
+    return jobs;
 }
 
 bool
 SessionPrivate::loadState(const QString& filename)
 {
+    QList<SdfPath> payloads;
+    if (!readState(filename, payloads))
+        return false;
+
+    WRITE_LOCKER(locker, &d.stageLock, "stageLock");
+    if (!d.stage)
+        return false;
+
+    return restoreState(d.stage, payloads);
+}
+
+bool
+SessionPrivate::readState(const QString& filename, QList<SdfPath>& payloads)
+{
+    payloads.clear();
+
     QFile file(QFileInfo(filename).absoluteFilePath());
     if (!file.exists())
         return true;
@@ -569,14 +1374,11 @@ SessionPrivate::loadState(const QString& filename)
     if (!doc.isObject())
         return false;
 
-    const QJsonObject root = doc.object();
-    const QJsonArray payloads = root.value("loadedPayloads").toArray();
-
-    WRITE_LOCKER(locker, &d.stageLock, "stageLock");
-    if (!d.stage)
-        return false;
-
-    for (const QJsonValue& value : payloads) {
+    const QJsonObject root = doc.object();
+    const QJsonArray values = root.value("loadedPayloads").toArray();
+    payloads.reserve(values.size());
+
+    for (const QJsonValue& value : values) {
         const QString pathString = value.toString().trimmed();
         if (pathString.isEmpty())
             continue;
@@ -585,15 +1387,46 @@ SessionPrivate::loadState(const QString& filename)
         if (!path.IsAbsolutePath())
             continue;
 
-        const UsdPrim prim = d.stage->GetPrimAtPath(path);
+        payloads.append(path);
+    }
+    return true;
+}
+
+bool
+SessionPrivate::restoreState(const UsdStageRefPtr& stage, const QList<SdfPath>& payloads,
+                             const std::function<bool(size_t, size_t)>& progress)
+{
+    if (!stage)
+        return false;
+
+    SdfPathVector loadPaths;
+    loadPaths.reserve(payloads.size());
+    for (const SdfPath& path : payloads) {
+        const UsdPrim prim = stage->GetPrimAtPath(path);
         if (!prim || !prim.IsValid())
             continue;
-        if (!stage::isPayload(d.stage, path))
+        if (!stage::isPayload(stage, path))
             continue;
-
-        prim.Load();
+        if (!prim.IsLoaded())
+            loadPaths.push_back(path);
     }
 
+    // a single LoadAndUnload per chunk lets Pcp index all payloads in parallel
+    // instead of recomposing and notifying once per prim
+    // progress is told the total before the first chunk
+    const size_t total = loadPaths.size();
+    if (progress && !progress(0, total))
+        return false;
+
+    const size_t chunkSize = progress ? std::max<size_t>(1, std::min<size_t>(total, restoreChunkSize)) : total;
+    for (size_t begin = 0; begin < total; begin += chunkSize) {
+        const size_t end = std::min(begin + chunkSize, total);
+        const SdfPathSet loadSet(loadPaths.begin() + begin, loadPaths.begin() + end);
+        stage->LoadAndUnload(loadSet, SdfPathSet());
+
+        if (progress && !progress(end, total))
+            return false;
+    }
     return true;
 }
 
@@ -641,23 +1474,38 @@ SessionPrivate::saveState(const QString& filename)
 }
 
 bool
-SessionPrivate::close()
+SessionPrivate::close(bool cache)
 {
+    endLoading();
+    cancelExports();
+    const bool blocked = d.changeDepth > 0;
+    const QString blockName = d.changeName;
     {
         WRITE_LOCKER(locker, &d.stageLock, "stageLock");
         StageBlocker blocker(d.stageWatcher.data());
         d.stageWatcher->init();
+        if (cache)
+            retireStage();
         d.stage = nullptr;
         d.stageStatus = Session::StageStatus::Closed;
-        d.pendingNotices.entries.clear();
+        d.pendingNotices.clear();
         d.changeDepth = 0;
+        d.blockGeneration++;
         d.expectedChanges = 0;
         d.completedChanges = 0;
         d.changeName.clear();
         d.changeCancelled.store(false);
         d.filename.clear();
+        d.cacheKey.clear();
+        d.layerStamps.clear();
+        d.loadGeneration++;
     }
 
+    // open blocks are dropped, their late endProgressBlock(block) calls are ignored
+    if (blocked)
+        Q_EMIT d.session->progressBlockChanged(blockName, Session::ProgressMode::Idle);
+
+    d.layerWatcher->clear();
     d.commandStack->clear();
     d.selectionList->clear();
 
@@ -670,6 +1518,7 @@ SessionPrivate::reload()
 {
     QString filename;
     Session::LoadPolicy loadPolicy;
+    Session::LoadOptions loadOptions;
 
     {
         READ_LOCKER(locker, &d.stageLock, "stageLock");
@@ -678,13 +1527,269 @@ SessionPrivate::reload()
 
         filename = d.filename;
         loadPolicy = d.loadPolicy;
+        loadOptions = d.loadOptions;
     }
 
     if (filename.isEmpty())
         return false;
 
-    close();
-    return loadFromFile(filename, loadPolicy);
+    // cached stages keep their layers open in the layer registry, drop
+    // them so every layer is read from disk again
+    close(false);
+    d.stageCache->clear();
+    return loadFromFile(filename, loadPolicy, loadOptions);
+}
+
+bool
+SessionPrivate::reloadChanged()
+{
+    std::vector<SdfLayerHandle> layers;
+    QStringList skipped;
+    {
+        READ_LOCKER(locker, &d.stageLock, "stageLock");
+        if (!d.stage)
+            return false;
+
+        // reloading would discard unsaved edits, dirty layers are left alone
+        for (const SdfLayerHandle& layer : changedLayers()) {
+            if (layer->IsDirty())
+                skipped.append(StringToQString(layer->GetIdentifier()));
+            else
+                layers.push_back(layer);
+        }
+    }
+
+    for (const QString& identifier : skipped)
+        d.session->notifyStatus(Session::Notify::Status::Warning,
+                                QString("Layer has unsaved changes, reload skipped: %1").arg(identifier));
+
+    if (layers.empty())
+        return true;
+
+    beginProgressBlock("reload layers", layers.size());
+
+    std::vector<SdfLayerHandle> reloaded;
+    const bool success = reloadLayers(
+        layers, [this](const Session::Notify& notify, size_t completed) { updateProgressNotify(notify, completed); },
+        reloaded);
+
+    {
+        WRITE_LOCKER(locker, &d.stageLock, "stageLock");
+        stampLayers(reloaded);
+    }
+
+    endProgressBlock();
+    return success;
+}
+
+bool
+SessionPrivate::reloadLayers(const std::vector<SdfLayerHandle>& layers,
+                             const std::function<void(const Session::Notify&, size_t)>& notify,
+                             std::vector<SdfLayerHandle>& reloaded)
+{
+    bool success = true;
+    reloaded.reserve(layers.size());
+    for (size_t i = 0; i < layers.size(); ++i) {
+        if (isProgressBlockCancelled())
+            break;
+
+        const SdfLayerHandle& layer = layers[i];
+        bool layerReloaded = false;
+        {
+            WRITE_LOCKER(locker, &d.stageLock, "stageLock");
+            try {
+                layerReloaded = layer && layer->Reload(true);
+            } catch (const std::exception&) {
+                layerReloaded = false;
+            }
+        }
+
+        const QString identifier = layer ? StringToQString(layer->GetIdentifier()) : QString();
+        if (layerReloaded) {
+            reloaded.push_back(layer);
+            notify(Session::Notify(QString("layer reloaded: %1").arg(identifier), {}, Session::Notify::Status::Progress),
+                   i + 1);
+        }
+        else {
+            success = false;
+            notify(Session::Notify(QString("layer reload failed: %1").arg(identifier), {},
+                                   Session::Notify::Status::Error),
+                   i + 1);
+        }
+    }
+    return success;
+}
+
+void
+SessionPrivate::refreshLayers()
+{
+    if (!d.autoRefresh)
+        return;
+
+    if (d.loadJob || d.changeDepth > 0) {
+        // retry once the running operation has finished
+        if (!d.refreshQueued) {
+            d.refreshQueued = true;
+            QTimer::singleShot(d.layerWatcher->debounce(), d.session, [this]() {
+                d.refreshQueued = false;
+                refreshLayers();
+            });
+        }
+        return;
+    }
+
+    std::vector<SdfLayerHandle> layers;
+    QStringList skipped;
+    {
+        READ_LOCKER(locker, &d.stageLock, "stageLock");
+        if (!d.stage)
+            return;
+
+        // layers with unsaved edits are left alone so a live refresh
+        // never discards work
+        for (const SdfLayerHandle& layer : changedLayers()) {
+            if (layer->IsDirty())
+                skipped.append(StringToQString(layer->GetIdentifier()));
+            else
+                layers.push_back(layer);
+        }
+    }
+
+    for (const QString& identifier : skipped)
+        d.session->notifyStatus(Session::Notify::Status::Warning,
+                                QString("Layer has unsaved changes, refresh skipped: %1").arg(identifier));
+
+    if (layers.empty())
+        return;
+
+    const quint64 generation = d.loadGeneration.load();
+    const QPointer<Session> session = d.session;
+    const quint64 block = beginProgressBlock("refresh layers", layers.size());
+
+    QThreadPool::globalInstance()->start([this, session, layers, generation, block]() {
+        std::vector<SdfLayerHandle> reloaded;
+        reloadLayers(
+            layers,
+            [this, session, generation](const Session::Notify& notify, size_t completed) {
+                if (!session)
+                    return;
+                QMetaObject::invokeMethod(
+                    session,
+                    [this, notify, completed, generation]() {
+                        if (generation == d.loadGeneration.load())
+                            updateProgressNotify(notify, completed);
+                    },
+                    Qt::QueuedConnection);
+            },
+            reloaded);
+
+        if (!session)
+            return;
+
+        QMetaObject::invokeMethod(
+            session, [this, reloaded, generation, block]() {
+                finishRefresh(reloaded, generation, block);
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void
+SessionPrivate::finishRefresh(const std::vector<SdfLayerHandle>& reloaded, quint64 generation, quint64 block)
+{
+    // a load started meanwhile still needs the refresh block closed, or notices stay deferred,
+    // after close() the block is gone and another operation's block must not be ended
+    if (generation != d.loadGeneration.load()) {
+        endProgressBlock(block);
+        return;
+    }
+
+    {
+        WRITE_LOCKER(locker, &d.stageLock, "stageLock");
+        stampLayers(reloaded);
+    }
+
+    endProgressBlock(block);
+    watchLayers();
+}
+
+void
+SessionPrivate::watchLayers()
+{
+    if (!d.autoRefresh) {
+        d.layerWatcher->clear();
+        return;
+    }
+
+    QStringList files;
+    {
+        READ_LOCKER(locker, &d.stageLock, "stageLock");
+        if (d.stage) {
+            const SdfLayerHandle sessionLayer = d.stage->GetSessionLayer();
+            for (const SdfLayerHandle& layer : d.stage->GetUsedLayers(true)) {
+                if (!layer || layer->IsAnonymous() || layer == sessionLayer)
+                    continue;
+
+                const QString path = StringToQString(layer->GetRealPath());
+                if (!path.isEmpty())
+                    files.append(path);
+            }
+        }
+    }
+    d.layerWatcher->setFiles(files);
+}
+
+std::vector<SdfLayerHandle>
+SessionPrivate::changedLayers() const
+{
+    std::vector<SdfLayerHandle> layers;
+    if (!d.stage)
+        return layers;
+
+    const SdfLayerHandle sessionLayer = d.stage->GetSessionLayer();
+    for (const SdfLayerHandle& layer : d.stage->GetUsedLayers(true)) {
+        if (!layer || layer->IsAnonymous() || layer == sessionLayer)
+            continue;
+
+        const QString path = StringToQString(layer->GetRealPath());
+        if (path.isEmpty())
+            continue;
+
+        const QFileInfo info(path);
+        if (!info.exists())
+            continue;
+
+        // unsaved edits are not a change on disk
+        bool changed = false;
+        const auto it = d.layerStamps.constFind(path);
+        if (it != d.layerStamps.constEnd())
+            changed = it->modified != info.lastModified() || it->size != info.size();
+        else
+            changed = info.lastModified() > d.layerStampTime;
+
+        if (changed)
+            layers.push_back(layer);
+    }
+    return layers;
+}
+
+void
+SessionPrivate::stampLayers(const std::vector<SdfLayerHandle>& layers)
+{
+    for (const SdfLayerHandle& layer : layers) {
+        if (!layer || layer->IsAnonymous())
+            continue;
+
+        const QString path = StringToQString(layer->GetRealPath());
+        if (path.isEmpty())
+            continue;
+
+        const QFileInfo info(path);
+        LayerStamp stamp;
+        stamp.modified = info.lastModified();
+        stamp.size = info.size();
+        d.layerStamps.insert(path, stamp);
+    }
 }
 
 bool
@@ -694,6 +1799,12 @@ SessionPrivate::isLoaded() const
     return d.stage != nullptr;
 }
 
+bool
+SessionPrivate::isLoading() const
+{
+    return bool(d.loadJob);
+}
+
 void
 SessionPrivate::setMask(const QList<SdfPath>& paths)
 {
@@ -780,39 +1891,85 @@ SessionPrivate::boundingBox()
 {
     UsdStageRefPtr stage;
     QList<SdfPath> mask;
+    std::shared_ptr<BoundsCache> bounds;
     {
         READ_LOCKER(locker, &d.stageLock, "stageLock");
         stage = d.stage;
         mask = d.mask;
+        bounds = d.bounds;
     }
 
     Q_ASSERT(stage && "stage is not loaded");
     if (!stage)
         return GfBBox3d();
 
-    if (mask.isEmpty()) {
-        UsdGeomBBoxCache bboxCache(UsdTimeCode::Default(), UsdGeomImageable::GetOrderedPurposeTokens(), true);
-        return bboxCache.ComputeWorldBound(stage->GetPseudoRoot());
-    }
+    if (mask.isEmpty())
+        return bounds->compute(stage);
 
-    return stage::boundingBox(stage, mask);
+    return bounds->compute(stage, mask);
 }
 
-bool
-SessionPrivate::needsBoundingBoxUpdate(const NoticeBatch& batch) const
+void
+SessionPrivate::resetBounds(const std::shared_ptr<BoundsCache>& bounds)
 {
-    for (const NoticeEntry& entry : batch.entries) {
-        if (entry.resolvedAssetPathsResynced)
-            return true;
+    WRITE_LOCKER(locker, &d.stageLock, "stageLock");
+    d.bounds = bounds ? bounds : std::make_shared<BoundsCache>();
+    d.boundsGeneration++;
+}
+
+void
+SessionPrivate::updateBounds()
+{
+    if (d.boundsRunning) {
+        d.boundsQueued = true;
+        return;
+    }
+
+    const QPointer<Session> session = d.session;
+    if (!session)
+        return;
+
+    d.boundsRunning = true;
+    d.boundsQueued = false;
+    const quint64 generation = d.boundsGeneration;
+
+    QThreadPool::globalInstance()->start([this, session, generation]() {
+        GfBBox3d bbox;
+        bool valid = false;
+        try {
+            READ_LOCKER(locker, &d.stageLock, "stageLock");
+            if (d.stage && generation == d.boundsGeneration) {
+                bbox = d.mask.isEmpty() ? d.bounds->compute(d.stage) : d.bounds->compute(d.stage, d.mask);
+                valid = true;
+            }
+        } catch (...) {
+            valid = false;
+        }
+
+        if (!session)
+            return;
+
+        QMetaObject::invokeMethod(
+            session, [this, bbox, valid, generation]() { finishBounds(bbox, valid, generation); },
+            Qt::QueuedConnection);
+    });
+}
 
-        if (entry.primResyncType != UsdNotice::ObjectsChanged::PrimResyncType::Invalid)
-            return true;
+void
+SessionPrivate::finishBounds(const GfBBox3d& bbox, bool valid, quint64 generation)
+{
+    d.boundsRunning = false;
 
-        if (entry.changedInfoOnly && !entry.path.IsPropertyPath())
-            return true;
+    if (valid && generation == d.boundsGeneration) {
+        {
+            WRITE_LOCKER(locker, &d.stageLock, "stageLock");
+            d.bbox = bbox;
+        }
+        Q_EMIT d.session->boundingBoxChanged(bbox);
     }
 
-    return false;
+    if (d.boundsQueued)
+        updateBounds();
 }
 
 void
@@ -822,50 +1979,54 @@ SessionPrivate::updatePrims(const NoticeBatch& batch)
         return;
 
     if (d.changeDepth > 0 || d.primsUpdate == Session::PrimsUpdate::Deferred) {
-        d.pendingNotices.entries.append(batch.entries);
+        d.pendingNotices.append(batch);
         return;
     }
 
-    const bool updateBBox = needsBoundingBoxUpdate(batch);
-
-    if (updateBBox) {
-        const GfBBox3d bbox = boundingBox();
-        {
-            WRITE_LOCKER(locker, &d.stageLock, "stageLock");
-            d.bbox = bbox;
-        }
-
-        Q_EMIT d.session->primsChanged(batch);
-        Q_EMIT d.session->boundingBoxChanged(bbox);
-    }
-    else {
-        Q_EMIT d.session->primsChanged(batch);
+    const NoticeBatch coalesced = NoticeCoalescer::coalesce(batch);
+    const QList<SdfPath> paths = BoundsCache::changedPaths(coalesced);
+    if (!paths.isEmpty()) {
+        d.bounds->invalidate(paths);
+        updateBounds();
     }
+    d.statisticsCache->invalidate(coalesced);
+
+    Q_EMIT d.session->primsChanged(coalesced);
+    watchResyncedLayers(coalesced);
 }
 
 void
 SessionPrivate::flushPrims()
 {
-    if (d.pendingNotices.entries.isEmpty())
+    d.stageWatcher->dispatch();
+    if (d.pendingNotices.isEmpty())
         return;
 
-    const NoticeBatch batch = d.pendingNotices;
-    d.pendingNotices.entries.clear();
+    const NoticeBatch batch = d.pendingNotices.take();
 
-    const bool updateBBox = needsBoundingBoxUpdate(batch);
+    const QList<SdfPath> paths = BoundsCache::changedPaths(batch);
+    if (!paths.isEmpty()) {
+        d.bounds->invalidate(paths);
+        updateBounds();
+    }
+    d.statisticsCache->invalidate(batch);
 
-    if (updateBBox) {
-        const GfBBox3d bbox = boundingBox();
-        {
-            WRITE_LOCKER(locker, &d.stageLock, "stageLock");
-            d.bbox = bbox;
-        }
+    Q_EMIT d.session->primsChanged(batch);
+    watchResyncedLayers(batch);
+}
 
-        Q_EMIT d.session->primsChanged(batch);
-        Q_EMIT d.session->boundingBoxChanged(bbox);
-    }
-    else {
-        Q_EMIT d.session->primsChanged(batch);
+void
+SessionPrivate::watchResyncedLayers(const NoticeBatch& batch)
+{
+    // payload loads and sublayer edits change the used layers
+    if (!d.autoRefresh)
+        return;
+
+    for (const NoticeEntry& entry : batch.entries) {
+        if (!entry.changedInfoOnly) {
+            watchLayers();
+            return;
+        }
     }
 }
 
@@ -885,6 +2046,8 @@ SessionPrivate::updateStage()
         bbox = d.bbox;
     }
 
+    // before views are told, so they never read statistics of the previous stage
+    d.statisticsCache->setStage(stage, &d.stageLock);
     Q_EMIT d.session->stageChanged(stage, loadPolicy, stageStatus);
     Q_EMIT d.session->stageUpChanged(stageUp());
     Q_EMIT d.session->boundingBoxChanged(bbox);
@@ -948,15 +2111,25 @@ Session::newStage(Session::LoadPolicy policy)
 }
 
 bool
-Session::loadFromFile(const QString& filename, Session::LoadPolicy loadPolicy)
+Session::loadFromFile(const QString& filename, Session::LoadPolicy loadPolicy, Session::LoadMode mode)
+{
+    return loadFromFile(filename, LoadOptions(), loadPolicy, mode);
+}
+
+bool
+Session::loadFromFile(const QString& filename, const LoadOptions& options, Session::LoadPolicy loadPolicy,
+                      Session::LoadMode mode)
 {
-    return p->loadFromFile(filename, loadPolicy);
+    if (mode == Session::LoadMode::Background)
+        return p->loadFromFileAsync(filename, loadPolicy, options);
+
+    return p->loadFromFile(filename, loadPolicy, options);
 }
 
 bool
-Session::mergeFromFile(const QString& filename)
+Session::mergeFromFile(const QString& filename, LoadMode mode)
 {
-    return p->mergeFromFile(filename);
+    return p->mergeFromFile(filename, mode);
 }
 
 bool
@@ -974,29 +2147,68 @@ Session::copyToFile(const QString& filename)
 bool
 Session::flattenToFile(const QString& filename)
 {
-    READ_LOCKER(locker, stageLock(), "stageLock");
-    if (!p->d.stage)
-        return false;
-
-    try {
-        return p->d.stage->Export(QStringToString(QFileInfo(filename).absoluteFilePath()));
-    } catch (const std::exception&) {
-        return false;
-    }
+    return p->flattenPathsToFile(QList<SdfPath>(), filename);
 }
 
 bool
 Session::flattenPathsToFile(const QList<SdfPath>& paths, const QString& filename)
 {
+    if (paths.isEmpty())
+        return false;
+
     return p->flattenPathsToFile(paths, filename);
 }
 
+int
+Session::exportToFile(const QString& filename, const QList<SdfPath>& paths)
+{
+    return p->queueExport(filename, paths);
+}
+
+void
+Session::cancelExports()
+{
+    p->cancelExports();
+}
+
+int
+Session::pendingExports() const
+{
+    return int(p->d.exportQueue.size()) + p->d.exportsRunning;
+}
+
+int
+Session::exportConcurrency() const
+{
+    return p->d.exportConcurrency;
+}
+
+void
+Session::setExportConcurrency(int concurrency)
+{
+    p->d.exportConcurrency = qMax(1, concurrency);
+    p->startExports();
+}
+
 bool
-Session::reload()
+Session::reload(ReloadMode mode)
 {
+    if (mode == ReloadMode::Changed)
+        return p->reloadChanged();
+
     return p->reload();
 }
 
+QStringList
+Session::changedLayers() const
+{
+    QStringList identifiers;
+    READ_LOCKER(locker, stageLock(), "stageLock");
+    for (const SdfLayerHandle& layer : p->changedLayers())
+        identifiers.append(StringToQString(layer->GetIdentifier()));
+    return identifiers;
+}
+
 bool
 Session::close()
 {
@@ -1009,6 +2221,18 @@ Session::isLoaded() const
     return p->isLoaded();
 }
 
+bool
+Session::isLoading() const
+{
+    return p->isLoading();
+}
+
+void
+Session::cancelLoad()
+{
+    p->cancelLoad();
+}
+
 Session::StageUp
 Session::stageUp()
 {
@@ -1053,6 +2277,13 @@ Session::loadPolicy() const
     return p->d.loadPolicy;
 }
 
+Session::LoadOptions
+Session::loadOptions() const
+{
+    READ_LOCKER(locker, stageLock(), "stageLock");
+    return p->d.loadOptions;
+}
+
 QString
 Session::filename() const
 {
@@ -1122,4 +2353,50 @@ Session::flushPrimsUpdates()
     p->flushPrims();
 }
 
+int
+Session::noticeInterval() const
+{
+    return p->d.stageWatcher->interval();
+}
+
+void
+Session::setNoticeInterval(int msecs)
+{
+    p->d.stageWatcher->setInterval(msecs);
+}
+
+bool
+Session::autoRefresh() const
+{
+    return p->d.autoRefresh;
+}
+
+void
+Session::setAutoRefresh(bool enabled)
+{
+    if (p->d.autoRefresh == enabled)
+        return;
+
+    p->d.autoRefresh = enabled;
+    p->watchLayers();
+}
+
+StageCache*
+Session::stageCache() const
+{
+    return p->d.stageCache.get();
+}
+
+StatisticsCache*
+Session::statisticsCache() const
+{
+    return p->d.statisticsCache.data();
+}
+
+Session::NoticeStatistics
+Session::noticeStatistics() const
+{
+    return p->d.stageWatcher->statistics();
+}
+
 }  // namespace usdviewer
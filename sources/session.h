@@ -20,6 +20,8 @@ namespace usdviewer {
 class CommandStack;
 class SelectionList;
 class SessionPrivate;
+class StageCache;
+class StatisticsCache;
 
 /**
  * @class Session
@@ -45,6 +47,14 @@ public:
         None  ///< Open the stage without loading payloads.
     };
 
+    /**
+     * @brief Stage open mode.
+     */
+    enum LoadMode {
+        Blocking,   ///< Open the stage on the calling thread.
+        Background  ///< Open the stage on a worker thread.
+    };
+
     /**
      * @brief Progress block state.
      */
@@ -70,6 +80,14 @@ public:
         Closed   ///< Stage has been closed.
     };
 
+    /**
+     * @brief Stage reload mode.
+     */
+    enum ReloadMode {
+        Full,    ///< Close and reopen the stage.
+        Changed  ///< Reload only layers changed on disk.
+    };
+
     /**
      * @brief Stage up axis.
      */
@@ -104,6 +122,44 @@ public:
         {}
     };
 
+    /**
+     * @struct LoadOptions
+     * @brief Composition scope applied when opening a stage.
+     *
+     * A non-empty mask opens the stage with a population mask so only the
+     * listed prims, their ancestors and descendants are composed. A load
+     * rules file refines which payloads are loaded on top of the policy.
+     */
+    struct LoadOptions {
+        QList<SdfPath> mask;  ///< Population mask paths, empty for the full stage.
+        QString loadRules;    ///< Load rules file, empty for the policy default.
+
+        bool isEmpty() const { return mask.isEmpty() && loadRules.isEmpty(); }
+    };
+
+    /**
+     * @struct ExportJob
+     * @brief Queued background export.
+     */
+    struct ExportJob {
+        int id = 0;            ///< Job identifier returned by exportToFile().
+        QString filename;      ///< Destination file.
+        QList<SdfPath> paths;  ///< Exported prim paths, empty for the whole stage.
+    };
+
+    /**
+     * @struct NoticeStatistics
+     * @brief Counters for stage change notice dispatch.
+     *
+     * Notices are accumulated as they arrive and delivered as one merged
+     * batch per notice interval.
+     */
+    struct NoticeStatistics {
+        quint64 received = 0;   ///< Stage notices received.
+        quint64 merged = 0;     ///< Notices merged into another notice's batch.
+        quint64 delivered = 0;  ///< Merged batches delivered.
+    };
+
 public:
     /**
      * @brief Constructs an empty session.
@@ -179,12 +235,45 @@ public:
     /**
      * @brief Loads a USD stage from file.
      *
+     * In Background mode the stage is composed on a worker thread with its
+     * own progress, cancelled with cancelLoad() and not by progress blocks.
+     * The current stage stays active until the new stage is ready, at which
+     * point stageChanged() is emitted, followed by loadFinished() for both
+     * success and failure.
+     *
      * @param filename File to load.
      * @param policy Stage loading policy.
+     * @param mode Blocking or background open.
      *
-     * @return True if loading succeeded.
+     * @return True if loading succeeded, or in Background mode, if loading
+     *         was started.
      */
-    bool loadFromFile(const QString& filename, LoadPolicy policy = LoadPolicy::All);
+    bool loadFromFile(const QString& filename, LoadPolicy policy = LoadPolicy::All,
+                      LoadMode mode = LoadMode::Blocking);
+
+    /**
+     * @brief Loads a USD stage from file with a population mask and load rules.
+     *
+     * The stage is opened with UsdStage::OpenMasked() and the load rules
+     * from @p options are applied before payloads are loaded, so only the
+     * requested part of the stage is composed. The options are kept and
+     * reused by reload().
+     *
+     * Load rules files are JSON documents with a "rules" array of
+     * { "path": "/World/A", "rule": "all" | "only" | "none" } objects.
+     * A ".session" file is also accepted, its "loadedPayloads" are
+     * loaded with their descendants.
+     *
+     * @param filename File to load.
+     * @param options Population mask and load rules.
+     * @param policy Stage loading policy.
+     * @param mode Blocking or background open.
+     *
+     * @return True if loading succeeded, or in Background mode, if loading
+     *         was started.
+     */
+    bool loadFromFile(const QString& filename, const LoadOptions& options, LoadPolicy policy = LoadPolicy::All,
+                      LoadMode mode = LoadMode::Blocking);
 
     /**
      * @brief Merges a USD file or session state file into the current stage.
@@ -195,13 +284,19 @@ public:
      * If @p filename refers to a ".session" file, only the stored payload
      * load state is applied to the current stage.
      *
-     * Unlike loadFromFile(), this does not replace the current stage.
+     * Unlike loadFromFile(), this does not replace the current stage. The
+     * merged file is opened as a layer only and added as a sublayer, so it
+     * is composed once, as part of the current stage.
+     *
+     * With LoadMode::Background the merge runs on a worker thread inside
+     * a cancellable progress block and mergeFinished() is emitted when done.
      *
      * @param filename USD file or ".session" state file to merge.
+     * @param mode Merge on the calling thread or on a worker thread.
      *
-     * @return True if the merge succeeded.
+     * @return True if the merge succeeded, or for Background, if it was started.
      */
-    bool mergeFromFile(const QString& filename);
+    bool mergeFromFile(const QString& filename, LoadMode mode = LoadMode::Blocking);
 
     /**
      * @brief Saves the current stage to file.
@@ -223,10 +318,73 @@ public:
      */
     bool flattenPathsToFile(const QList<SdfPath>& paths, const QString& filename);
 
+    /**
+     * @brief Queues a background export of the stage or of prim paths.
+     *
+     * The stage, or the subtree of each path when @p paths is not empty, is
+     * flattened on a worker thread and written to @p filename. The stage
+     * lock is only held for reading while flattening in memory, writing
+     * the file runs unlocked. Exports report progress on their own, outside
+     * progress blocks, so stage notices are not deferred while they run.
+     * Every job has its own cancel flag, cancelExports() and replacing or
+     * closing the stage cancel them, progress block cancels do not. Up to
+     * exportConcurrency() exports run at the same time and exportFinished()
+     * is emitted for every job.
+     *
+     * @return Job identifier, or 0 if no stage is loaded.
+     */
+    int exportToFile(const QString& filename, const QList<SdfPath>& paths = QList<SdfPath>());
+
+    /**
+     * @brief Cancels queued and running exports.
+     */
+    void cancelExports();
+
+    /**
+     * @brief Returns the number of queued and running exports.
+     */
+    int pendingExports() const;
+
+    /**
+     * @brief Returns the maximum number of exports running at the same time.
+     */
+    int exportConcurrency() const;
+
+    /**
+     * @brief Sets the maximum number of exports running at the same time.
+     */
+    void setExportConcurrency(int concurrency);
+
     /**
      * @brief Reloads the currently opened stage.
+     *
+     * Full closes and reopens the stage. Changed reloads only the used
+     * layers whose file modification time or size differs from when they
+     * were opened. Layers with unsaved edits are skipped with a warning.
+     * The affected prims are recomposed and reported through
+     * primsChanged(), while the stage, tree and selection are kept.
+     */
+    bool reload(ReloadMode mode = ReloadMode::Full);
+
+    /**
+     * @brief Returns the identifiers of used layers changed on disk.
+     */
+    QStringList changedLayers() const;
+
+    /**
+     * @brief Returns whether layers are refreshed when changed on disk.
      */
-    bool reload();
+    bool autoRefresh() const;
+
+    /**
+     * @brief Enables or disables live refresh of layers changed on disk.
+     *
+     * When enabled, every used layer, including loaded payload layers, is
+     * watched on disk. Changes are debounced and the changed layers are
+     * reloaded on a worker thread, so only affected prims are reported
+     * through primsChanged(). Layers with unsaved edits are skipped.
+     */
+    void setAutoRefresh(bool enabled);
 
     /**
      * @brief Closes the current stage.
@@ -238,6 +396,16 @@ public:
      */
     bool isLoaded() const;
 
+    /**
+     * @brief Returns whether a background load is in progress.
+     */
+    bool isLoading() const;
+
+    /**
+     * @brief Cancels a background load, the current stage is kept.
+     */
+    void cancelLoad();
+
     ///@}
 
     /** @name Scene State */
@@ -268,6 +436,11 @@ public:
      */
     LoadPolicy loadPolicy() const;
 
+    /**
+     * @brief Returns the population mask and load rules of the current stage.
+     */
+    LoadOptions loadOptions() const;
+
     /**
      * @brief Returns the scene bounding box.
      */
@@ -310,6 +483,25 @@ public:
      */
     SelectionList* selectionList() const;
 
+    /**
+     * @brief Returns the stage cache subsystem.
+     *
+     * Stages released by load, close or new are kept in the cache and
+     * reused when the same file is opened again with the same settings.
+     * The settings include the modification time and size of the load
+     * rules file. A reused stage gets its payload load state reset to the
+     * load rules and ".session" file, as a fresh open would.
+     */
+    StageCache* stageCache() const;
+
+    /**
+     * @brief Returns the subtree statistics subsystem.
+     *
+     * Follows the current stage and prim changes, and is computed only
+     * while a view has it enabled.
+     */
+    StatisticsCache* statisticsCache() const;
+
     ///@}
 
     /**
@@ -330,6 +522,25 @@ public:
      */
     void flushPrimsUpdates();
 
+    /**
+     * @brief Returns the notice dispatch interval in milliseconds.
+     */
+    int noticeInterval() const;
+
+    /**
+     * @brief Sets the notice dispatch interval in milliseconds.
+     *
+     * Stage notices received within the interval are merged and delivered
+     * as a single batch. The default matches one display frame at 60 Hz,
+     * zero delivers once per event loop iteration.
+     */
+    void setNoticeInterval(int msecs);
+
+    /**
+     * @brief Returns the notice dispatch counters.
+     */
+    NoticeStatistics noticeStatistics() const;
+
     /**
      * @brief Sets a textual status message.
      */
@@ -366,6 +577,34 @@ Q_SIGNALS:
      */
     void stageChanged(UsdStageRefPtr stage, LoadPolicy policy, StageStatus status);
 
+    /**
+     * @brief Emitted when a background load completes.
+     *
+     * @param filename File that was requested.
+     * @param loaded True if the stage replaced the current stage.
+     * @param cancelled True if the load was cancelled by the user.
+     */
+    void loadFinished(const QString& filename, bool loaded, bool cancelled);
+
+    /**
+     * @brief Emitted when a background merge completes.
+     *
+     * @param filename File that was requested.
+     * @param merged True if the file was merged into the current stage.
+     * @param cancelled True if the merge was cancelled by the user.
+     */
+    void mergeFinished(const QString& filename, bool merged, bool cancelled);
+
+    /**
+     * @brief Emitted when a queued export completes.
+     *
+     * @param id Job identifier returned by exportToFile().
+     * @param filename Destination file.
+     * @param exported True if the file was written.
+     * @param cancelled True if the export was cancelled.
+     */
+    void exportFinished(int id, const QString& filename, bool exported, bool cancelled);
+
     /**
      * @brief Emitted when the stage up axis changes.
      */
@@ -0,0 +1,244 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#include "stagecache.h"
+#include "boundscache.h"
+#include "qtutils.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QList>
+#include <QMutex>
+
+namespace usdviewer {
+class StageCachePrivate {
+public:
+    struct Stamp {
+        QString path;
+        QDateTime modified;
+        qint64 size = -1;
+    };
+
+    struct Entry {
+        QString key;
+        UsdStageRefPtr stage;
+        std::shared_ptr<BoundsCache> bounds;
+        QList<Stamp> stamps;
+        qint64 cost = 0;
+    };
+
+    static bool stamp(const UsdStageRefPtr& stage, Entry& entry);
+    static bool isStale(const Entry& entry);
+    void trim();
+
+public:
+    struct Data {
+        bool enabled = true;
+        int capacity;
+        qint64 budget;
+        qint64 cost = 0;
+        QList<Entry> entries;  // most recently used first
+        StageCache::Statistics statistics;
+        mutable QMutex mutex;
+    };
+    Data d;
+};
+
+bool
+StageCachePrivate::stamp(const UsdStageRefPtr& stage, Entry& entry)
+{
+    const SdfLayerHandle sessionLayer = stage->GetSessionLayer();
+    for (const SdfLayerHandle& layer : stage->GetUsedLayers(true)) {
+        if (!layer || layer->IsAnonymous() || layer == sessionLayer)
+            continue;
+        if (layer->IsDirty())
+            return false;
+
+        const QString path = StringToQString(layer->GetRealPath());
+        if (path.isEmpty())
+            continue;
+
+        const QFileInfo info(path);
+        Stamp stamp;
+        stamp.path = path;
+        stamp.modified = info.lastModified();
+        stamp.size = info.size();
+        entry.stamps.append(stamp);
+        entry.cost += qMax<qint64>(0, stamp.size);
+    }
+    return true;
+}
+
+bool
+StageCachePrivate::isStale(const Entry& entry)
+{
+    for (const Stamp& stamp : entry.stamps) {
+        const QFileInfo info(stamp.path);
+        if (info.lastModified() != stamp.modified || info.size() != stamp.size)
+            return true;
+    }
+    return false;
+}
+
+void
+StageCachePrivate::trim()
+{
+    while (!d.entries.isEmpty() && (d.entries.size() > d.capacity || d.cost > d.budget)) {
+        d.cost -= d.entries.last().cost;
+        d.entries.removeLast();
+        d.statistics.evictions++;
+    }
+}
+
+StageCache::StageCache(int capacity, qint64 budget)
+    : p(new StageCachePrivate())
+{
+    p->d.capacity = qMax(0, capacity);
+    p->d.budget = qMax<qint64>(0, budget);
+}
+
+StageCache::~StageCache() = default;
+
+bool
+StageCache::isEnabled() const
+{
+    QMutexLocker locker(&p->d.mutex);
+    return p->d.enabled;
+}
+
+void
+StageCache::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&p->d.mutex);
+    p->d.enabled = enabled;
+    if (!enabled) {
+        p->d.entries.clear();
+        p->d.cost = 0;
+    }
+}
+
+int
+StageCache::capacity() const
+{
+    QMutexLocker locker(&p->d.mutex);
+    return p->d.capacity;
+}
+
+void
+StageCache::setCapacity(int capacity)
+{
+    QMutexLocker locker(&p->d.mutex);
+    p->d.capacity = qMax(0, capacity);
+    p->trim();
+}
+
+qint64
+StageCache::budget() const
+{
+    QMutexLocker locker(&p->d.mutex);
+    return p->d.budget;
+}
+
+void
+StageCache::setBudget(qint64 budget)
+{
+    QMutexLocker locker(&p->d.mutex);
+    p->d.budget = qMax<qint64>(0, budget);
+    p->trim();
+}
+
+QString
+StageCache::key(const QString& filename, const QString& settings)
+{
+    return QFileInfo(filename).absoluteFilePath() + '|' + settings;
+}
+
+bool
+StageCache::insert(const QString& key, const UsdStageRefPtr& stage, const std::shared_ptr<BoundsCache>& bounds)
+{
+    if (!stage || key.isEmpty() || !isEnabled())
+        return false;
+
+    // stamping stats every used layer, keep it outside the lock
+    StageCachePrivate::Entry entry;
+    entry.key = key;
+    entry.stage = stage;
+    entry.bounds = bounds;
+    if (!StageCachePrivate::stamp(stage, entry))
+        return false;
+
+    QMutexLocker locker(&p->d.mutex);
+    for (qsizetype i = 0; i < p->d.entries.size(); ++i) {
+        if (p->d.entries[i].key == key) {
+            p->d.cost -= p->d.entries[i].cost;
+            p->d.entries.removeAt(i);
+            break;
+        }
+    }
+
+    p->d.cost += entry.cost;
+    p->d.entries.prepend(entry);
+    p->trim();
+    return !p->d.entries.isEmpty() && p->d.entries.first().key == key;
+}
+
+UsdStageRefPtr
+StageCache::take(const QString& key, std::shared_ptr<BoundsCache>* bounds)
+{
+    StageCachePrivate::Entry entry;
+    {
+        QMutexLocker locker(&p->d.mutex);
+        if (!p->d.enabled)
+            return UsdStageRefPtr();
+
+        qsizetype index = -1;
+        for (qsizetype i = 0; i < p->d.entries.size(); ++i) {
+            if (p->d.entries[i].key == key) {
+                index = i;
+                break;
+            }
+        }
+
+        if (index < 0) {
+            p->d.statistics.misses++;
+            return UsdStageRefPtr();
+        }
+
+        entry = p->d.entries.takeAt(index);
+        p->d.cost -= entry.cost;
+    }
+
+    const bool stale = StageCachePrivate::isStale(entry);
+
+    QMutexLocker locker(&p->d.mutex);
+    if (stale) {
+        p->d.statistics.evictions++;
+        p->d.statistics.misses++;
+        return UsdStageRefPtr();
+    }
+
+    p->d.statistics.hits++;
+    if (bounds)
+        *bounds = entry.bounds;
+    return entry.stage;
+}
+
+void
+StageCache::clear()
+{
+    QMutexLocker locker(&p->d.mutex);
+    p->d.entries.clear();
+    p->d.cost = 0;
+}
+
+StageCache::Statistics
+StageCache::statistics() const
+{
+    QMutexLocker locker(&p->d.mutex);
+    Statistics statistics = p->d.statistics;
+    statistics.count = int(p->d.entries.size());
+    statistics.cost = p->d.cost;
+    return statistics;
+}
+
+}  // namespace usdviewer
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#pragma once
+
+#include <QScopedPointer>
+#include <QString>
+#include <pxr/usd/usd/stage.h>
+#include <memory>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace usdviewer {
+
+class BoundsCache;
+class StageCachePrivate;
+
+/**
+ * @class StageCache
+ * @brief Bounded LRU cache of recently closed stages.
+ *
+ * Keeps composed stages alive after they are replaced or closed so
+ * reopening the same root layer with the same load policy skips
+ * composition. Stages are taken out of the cache while in use and put
+ * back when released, so a cached stage is never shared.
+ *
+ * The cache is bounded by an entry count and a memory budget. The cost
+ * of a stage is approximated by the on-disk size of its used layers.
+ * Stages with unsaved edits are not cached, and cached stages whose
+ * layers changed on disk are dropped when taken.
+ *
+ * All methods are thread-safe.
+ */
+class StageCache {
+public:
+    /**
+     * @struct Statistics
+     * @brief Cache counters since construction.
+     */
+    struct Statistics {
+        quint64 hits = 0;       ///< Stages served from the cache.
+        quint64 misses = 0;     ///< Lookups that required a fresh open.
+        quint64 evictions = 0;  ///< Stages dropped for budget or staleness.
+        int count = 0;          ///< Stages currently cached.
+        qint64 cost = 0;        ///< Approximate cost of cached stages in bytes.
+    };
+
+    /**
+     * @brief Constructs an empty stage cache.
+     *
+     * @param capacity Maximum number of cached stages.
+     * @param budget Memory budget in bytes.
+     */
+    StageCache(int capacity = 4, qint64 budget = qint64(1) << 30);
+
+    /**
+     * @brief Destroys the StageCache instance.
+     */
+    ~StageCache();
+
+    /**
+     * @brief Returns whether caching is enabled.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Enables or disables caching, disabling drops all stages.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Returns the maximum number of cached stages.
+     */
+    int capacity() const;
+
+    /**
+     * @brief Sets the maximum number of cached stages.
+     */
+    void setCapacity(int capacity);
+
+    /**
+     * @brief Returns the memory budget in bytes.
+     */
+    qint64 budget() const;
+
+    /**
+     * @brief Sets the memory budget in bytes.
+     */
+    void setBudget(qint64 budget);
+
+    /**
+     * @brief Returns the cache key for a stage file and load settings.
+     *
+     * @param filename Root layer file.
+     * @param settings Load policy and options serialized by the caller.
+     */
+    static QString key(const QString& filename, const QString& settings);
+
+    /**
+     * @brief Puts a released stage in the cache.
+     *
+     * @param key Cache key from key().
+     * @param stage Stage to keep alive.
+     * @param bounds Bounds cache matching the stage, may be null.
+     * @return True if the stage was cached.
+     */
+    bool insert(const QString& key, const UsdStageRefPtr& stage, const std::shared_ptr<BoundsCache>& bounds);
+
+    /**
+     * @brief Takes a stage out of the cache.
+     *
+     * Counts a hit or a miss. Stale stages are evicted and reported as misses.
+     *
+     * @param key Cache key from key().
+     * @param bounds Receives the cached bounds cache, may be null.
+     * @return The cached stage, or null on a miss.
+     */
+    UsdStageRefPtr take(const QString& key, std::shared_ptr<BoundsCache>* bounds = nullptr);
+
+    /**
+     * @brief Drops all cached stages.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the cache counters.
+     */
+    Statistics statistics() const;
+
+private:
+    Q_DISABLE_COPY_MOVE(StageCache)
+    QScopedPointer<StageCachePrivate> p;
+};
+
+}  // namespace usdviewer
@@ -0,0 +1,304 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#include "stagegenerator.h"
+#include "qtutils.h"
+#include <QDir>
+#include <QFileInfo>
+#include <pxr/usd/sdf/attributeSpec.h>
+#include <pxr/usd/sdf/changeBlock.h>
+#include <pxr/usd/sdf/layer.h>
+#include <pxr/usd/sdf/primSpec.h>
+#include <pxr/usd/sdf/types.h>
+#include <pxr/usd/sdf/variantSetSpec.h>
+#include <pxr/usd/sdf/variantSpec.h>
+#include <pxr/usd/usdGeom/tokens.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace usdviewer {
+class StageGeneratorPrivate {
+public:
+    struct Mesh {
+        VtVec3fArray points;
+        VtIntArray faceVertexCounts;
+        VtIntArray faceVertexIndices;
+        VtVec3fArray extent;
+    };
+
+    void init();
+    SdfLayerRefPtr createLayer(const QString& filename);
+    bool writeAsset(const QString& filename);
+    SdfPrimSpecHandle definePrim(const SdfPrimSpecHandle& parent, const std::string& name, const TfToken& typeName);
+    SdfPrimSpecHandle defineRoot(const SdfLayerHandle& layer, const std::string& name, const TfToken& typeName);
+    void defineMesh(const SdfPrimSpecHandle& parent, const std::string& name);
+    void defineVariants(const SdfPrimSpecHandle& prim);
+    bool fail(const QString& error);
+
+public:
+    struct Data {
+        StageGenerator::Options options;
+        StageGenerator::Statistics statistics;
+        Mesh mesh;
+        QString error;
+    };
+    Data d;
+};
+
+void
+StageGeneratorPrivate::init()
+{
+    // one shared grid, VtArray copies are reference counted so every mesh shares it
+    const int size = std::max(d.options.meshSize, 1);
+    Mesh mesh;
+    mesh.points.reserve((size + 1) * (size + 1));
+    for (int y = 0; y <= size; ++y) {
+        for (int x = 0; x <= size; ++x)
+            mesh.points.push_back(GfVec3f(float(x) / size - 0.5f, float(y) / size - 0.5f, 0.0f));
+    }
+    mesh.faceVertexCounts.assign(size * size, 4);
+    mesh.faceVertexIndices.reserve(size * size * 4);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const int i = y * (size + 1) + x;
+            mesh.faceVertexIndices.push_back(i);
+            mesh.faceVertexIndices.push_back(i + 1);
+            mesh.faceVertexIndices.push_back(i + size + 2);
+            mesh.faceVertexIndices.push_back(i + size + 1);
+        }
+    }
+    mesh.extent = { GfVec3f(-0.5f, -0.5f, 0.0f), GfVec3f(0.5f, 0.5f, 0.0f) };
+    d.mesh = mesh;
+    d.statistics = StageGenerator::Statistics();
+    d.error.clear();
+}
+
+SdfLayerRefPtr
+StageGeneratorPrivate::createLayer(const QString& filename)
+{
+    // layers still open from an earlier run are cleared and reused
+    const std::string path = qt::QStringToString(QFileInfo(filename).absoluteFilePath());
+    SdfLayerRefPtr layer = SdfLayer::Find(path);
+    if (layer) {
+        layer->Clear();
+        return layer;
+    }
+    return SdfLayer::CreateNew(path);
+}
+
+bool
+StageGeneratorPrivate::writeAsset(const QString& filename)
+{
+    SdfLayerRefPtr layer = createLayer(filename);
+    if (!layer)
+        return fail(QString("Failed to create asset layer: %1").arg(filename));
+
+    {
+        SdfChangeBlock changeBlock;
+        SdfPrimSpecHandle asset = defineRoot(layer, "Asset", UsdGeomTokens->Xform);
+        defineMesh(asset, "Mesh");
+        layer->SetDefaultPrim(TfToken("Asset"));
+    }
+    if (!layer->Save())
+        return fail(QString("Failed to save asset layer: %1").arg(filename));
+
+    d.statistics.layers.append(filename);
+    return true;
+}
+
+SdfPrimSpecHandle
+StageGeneratorPrivate::definePrim(const SdfPrimSpecHandle& parent, const std::string& name, const TfToken& typeName)
+{
+    return SdfPrimSpec::New(parent, name, SdfSpecifierDef, typeName.GetString());
+}
+
+SdfPrimSpecHandle
+StageGeneratorPrivate::defineRoot(const SdfLayerHandle& layer, const std::string& name, const TfToken& typeName)
+{
+    return SdfPrimSpec::New(layer, name, SdfSpecifierDef, typeName.GetString());
+}
+
+void
+StageGeneratorPrivate::defineMesh(const SdfPrimSpecHandle& parent, const std::string& name)
+{
+    SdfPrimSpecHandle mesh = definePrim(parent, name, UsdGeomTokens->Mesh);
+    SdfAttributeSpec::New(mesh, UsdGeomTokens->points.GetString(), SdfValueTypeNames->Point3fArray)
+        ->SetDefaultValue(VtValue(d.mesh.points));
+    SdfAttributeSpec::New(mesh, UsdGeomTokens->faceVertexCounts.GetString(), SdfValueTypeNames->IntArray)
+        ->SetDefaultValue(VtValue(d.mesh.faceVertexCounts));
+    SdfAttributeSpec::New(mesh, UsdGeomTokens->faceVertexIndices.GetString(), SdfValueTypeNames->IntArray)
+        ->SetDefaultValue(VtValue(d.mesh.faceVertexIndices));
+    SdfAttributeSpec::New(mesh, UsdGeomTokens->extent.GetString(), SdfValueTypeNames->Float3Array)
+        ->SetDefaultValue(VtValue(d.mesh.extent));
+}
+
+void
+StageGeneratorPrivate::defineVariants(const SdfPrimSpecHandle& prim)
+{
+    static const TfToken variantToken("generator:variant");
+    for (int set = 0; set < d.options.variantSets; ++set) {
+        const std::string setName = "set" + std::to_string(set);
+        SdfVariantSetSpecHandle variantSet = SdfVariantSetSpec::New(prim, setName);
+        for (int variant = 0; variant < std::max(d.options.variants, 1); ++variant) {
+            SdfVariantSpecHandle variantSpec = SdfVariantSpec::New(variantSet, "v" + std::to_string(variant));
+            SdfAttributeSpec::New(variantSpec->GetPrimSpec(), variantToken.GetString() + std::to_string(set),
+                                  SdfValueTypeNames->Int)
+                ->SetDefaultValue(VtValue(variant));
+        }
+        prim->GetVariantSetNameList().Prepend(setName);
+        prim->SetVariantSelection(setName, "v0");
+    }
+}
+
+bool
+StageGeneratorPrivate::fail(const QString& error)
+{
+    d.error = error;
+    return false;
+}
+
+StageGenerator::StageGenerator()
+    : p(new StageGeneratorPrivate())
+{}
+
+StageGenerator::StageGenerator(const Options& options)
+    : p(new StageGeneratorPrivate())
+{
+    p->d.options = options;
+}
+
+StageGenerator::~StageGenerator() {}
+
+StageGenerator::Options
+StageGenerator::options() const
+{
+    return p->d.options;
+}
+
+void
+StageGenerator::setOptions(const Options& options)
+{
+    p->d.options = options;
+}
+
+bool
+StageGenerator::generate(const QString& filename)
+{
+    p->init();
+    const Options& options = p->d.options;
+    const int depth = std::max(options.depth, 1);
+    const int fanOut = std::max(options.fanOut, 2);
+    const int prototypes = std::max(options.prototypes, 1);
+
+    const QFileInfo info(filename);
+    const QString suffix = info.suffix().isEmpty() ? QString("usdc") : info.suffix();
+    QStringList assetFilenames;
+    for (int i = 0; i < prototypes; ++i) {
+        assetFilenames.append(
+            info.dir().filePath(QString("%1.asset%2.%3").arg(info.completeBaseName()).arg(i).arg(suffix)));
+    }
+
+    SdfLayerRefPtr layer = p->createLayer(filename);
+    if (!layer)
+        return p->fail(QString("Failed to create layer: %1").arg(filename));
+    p->d.statistics.layers.append(info.absoluteFilePath());
+
+    const double payloadDensity = std::clamp(options.payloadDensity, 0.0, 1.0);
+    const double instanceRatio = std::clamp(options.instanceRatio, 0.0, 1.0);
+    const bool usesPayloads = payloadDensity > 0.0 && instanceRatio < 1.0;
+    if (usesPayloads) {
+        for (const QString& assetFilename : assetFilenames) {
+            if (!p->writeAsset(assetFilename))
+                return false;
+        }
+    }
+
+    // each leaf composes an Xform and a Mesh, groups add about 1 / (fanOut - 1) on top
+    const qint64 leaves = std::max<qint64>(1, qint64(options.prims / (2.0 + 1.0 / (fanOut - 1))));
+    Statistics& statistics = p->d.statistics;
+    std::mt19937 random(options.seed);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    {
+        SdfChangeBlock changeBlock;
+        SdfPrimSpecHandle world = p->defineRoot(layer, "World", UsdGeomTokens->Xform);
+        layer->SetDefaultPrim(TfToken("World"));
+        statistics.prims++;
+
+        if (instanceRatio > 0.0) {
+            SdfPrimSpecHandle prototypeRoot = SdfPrimSpec::New(layer, "Prototypes", SdfSpecifierClass);
+            statistics.prims++;
+            for (int i = 0; i < prototypes; ++i) {
+                SdfPrimSpecHandle prototype = p->definePrim(prototypeRoot, "Prototype" + std::to_string(i),
+                                                            UsdGeomTokens->Xform);
+                p->defineMesh(prototype, "Mesh");
+                statistics.prims += 2;
+            }
+        }
+
+        // group index at each level, levels are rebuilt when the leaf moves into a new group
+        std::vector<qint64> groupIndex(depth, -1);
+        std::vector<SdfPrimSpecHandle> groups(depth);
+        for (qint64 leaf = 0; leaf < leaves; ++leaf) {
+            qint64 index = leaf;
+            std::vector<qint64> indices(depth);
+            for (int level = depth - 1; level >= 0; --level) {
+                index /= fanOut;
+                indices[level] = index;
+            }
+            for (int level = 0; level < depth; ++level) {
+                if (indices[level] == groupIndex[level])
+                    continue;
+                const SdfPrimSpecHandle& parent = level == 0 ? world : groups[level - 1];
+                const qint64 child = level == 0 ? indices[level] : indices[level] % fanOut;
+                groups[level] = p->definePrim(parent, "Group" + std::to_string(child), UsdGeomTokens->Xform);
+                groupIndex[level] = indices[level];
+                std::fill(groupIndex.begin() + level + 1, groupIndex.end(), -1);
+                statistics.groups++;
+                statistics.prims++;
+            }
+
+            SdfPrimSpecHandle asset = p->definePrim(groups[depth - 1], "Asset" + std::to_string(leaf % fanOut),
+                                                    UsdGeomTokens->Xform);
+            const int prototype = int(leaf % prototypes);
+            if (distribution(random) < instanceRatio) {
+                asset->GetReferenceList().Prepend(
+                    SdfReference(std::string(), SdfPath("/Prototypes/Prototype" + std::to_string(prototype))));
+                asset->SetInstanceable(true);
+                statistics.instances++;
+            }
+            else if (usesPayloads && distribution(random) < payloadDensity) {
+                const QString assetPath = "./" + QFileInfo(assetFilenames[prototype]).fileName();
+                asset->GetPayloadList().Prepend(SdfPayload(qt::QStringToString(assetPath)));
+                statistics.payloads++;
+            }
+            else {
+                p->defineMesh(asset, "Mesh");
+                statistics.meshes++;
+                statistics.prims++;
+            }
+            p->defineVariants(asset);
+            statistics.leaves++;
+            statistics.prims++;
+        }
+    }
+
+    if (!layer->Save())
+        return p->fail(QString("Failed to save layer: %1").arg(filename));
+    return true;
+}
+
+StageGenerator::Statistics
+StageGenerator::statistics() const
+{
+    return p->d.statistics;
+}
+
+QString
+StageGenerator::error() const
+{
+    return p->d.error;
+}
+
+}  // namespace usdviewer
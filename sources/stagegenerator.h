@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#pragma once
+
+#include <QScopedPointer>
+#include <QString>
+#include <QStringList>
+
+namespace usdviewer {
+
+class StageGeneratorPrivate;
+
+/**
+ * @class StageGenerator
+ * @brief Writes synthetic USD stages for scale and regression testing.
+ *
+ * Generates a /World hierarchy of Xform groups with the configured depth
+ * and fan-out. Each leaf is an asset that is either an instance of a
+ * shared prototype, a payload to an external asset layer, or an inline
+ * mesh, chosen per leaf from the configured ratios with a seeded random
+ * generator, so the same options always produce the same stage.
+ *
+ * Layers are authored through the Sdf API inside a single change block,
+ * which keeps generation of multi-million prim stages practical. Payload
+ * asset layers are written next to the root layer using the same file
+ * format extension.
+ */
+class StageGenerator {
+public:
+    /**
+     * @struct Options
+     * @brief Generation parameters.
+     */
+    struct Options {
+        qint64 prims = 1000;          ///< Approximate number of composed prims.
+        int depth = 3;                ///< Group levels between /World and the leaves.
+        int fanOut = 10;              ///< Children per group.
+        double payloadDensity = 0.5;  ///< Fraction of non-instanced leaves behind payloads.
+        double instanceRatio = 0.0;   ///< Fraction of leaves that are instances.
+        int prototypes = 4;           ///< Distinct prototypes and payload asset layers.
+        int variantSets = 0;          ///< Variant sets authored on each leaf.
+        int variants = 2;             ///< Variants per variant set.
+        int meshSize = 8;             ///< Mesh grid resolution, meshSize x meshSize faces.
+        quint32 seed = 0;             ///< Random seed for leaf assignment.
+    };
+
+    /**
+     * @struct Statistics
+     * @brief Counts of what the last generation authored.
+     */
+    struct Statistics {
+        qint64 prims = 0;      ///< Prims authored in the root layer.
+        qint64 groups = 0;     ///< Xform group prims.
+        qint64 leaves = 0;     ///< Leaf asset prims.
+        qint64 meshes = 0;     ///< Inline meshes in the root layer.
+        qint64 payloads = 0;   ///< Leaves with a payload.
+        qint64 instances = 0;  ///< Instanceable leaves.
+        QStringList layers;    ///< Written layer files, root layer first.
+    };
+
+public:
+    /**
+     * @brief Constructs a generator with default options.
+     */
+    StageGenerator();
+
+    /**
+     * @brief Constructs a generator with the given options.
+     */
+    StageGenerator(const Options& options);
+
+    /**
+     * @brief Destroys the StageGenerator instance.
+     */
+    ~StageGenerator();
+
+    /**
+     * @brief Returns the generation options.
+     */
+    Options options() const;
+
+    /**
+     * @brief Sets the generation options.
+     */
+    void setOptions(const Options& options);
+
+    /**
+     * @brief Writes a stage to @p filename.
+     *
+     * Existing files are overwritten.
+     *
+     * @param filename Root layer file, the extension selects the format.
+     *
+     * @return True if all layers were written.
+     */
+    bool generate(const QString& filename);
+
+    /**
+     * @brief Returns the statistics of the last generation.
+     */
+    Statistics statistics() const;
+
+    /**
+     * @brief Returns the error of the last failed generation.
+     */
+    QString error() const;
+
+private:
+    Q_DISABLE_COPY_MOVE(StageGenerator)
+    QScopedPointer<StageGeneratorPrivate> p;
+};
+
+}  // namespace usdviewer
@@ -6,10 +6,14 @@
 #include "application.h"
 #include "command.h"
 #include "mime.h"
+#include "hierarchycache.h"
+#include "primcache.h"
+#include "primindex.h"
 #include "primitem.h"
 #include "qtutils.h"
 #include "selectionlist.h"
 #include "signalguard.h"
+#include "statisticscache.h"
 #include "style.h"
 #include "tracelocks.h"
 #include "usdutils.h"
@@ -33,6 +37,7 @@
 #include <pxr/usd/sdf/variantSetSpec.h>
 #include <pxr/usd/sdf/variantSpec.h>
 #include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usd/primRange.h>
 
 PXR_NAMESPACE_USING_DIRECTIVE
 
@@ -47,13 +52,26 @@ public:
     void collapse();
     void expand();
     void expandDepth(int targetDepth, const SdfPath& path);
+    void fetchDepth(PrimItem* item, int depthValue, int targetDepth);
+    void expandItems(QTreeWidgetItem* item, int depthValue, int targetDepth);
     int maxDepth(const SdfPath& path) const;
     int depth(const SdfPath& path) const;
     void toggleVisible(PrimItem* item);
     void updateFilter();
+    void startSearch();
+    void searchResults(int id, const QList<SdfPath>& paths);
+    void searchFinished(int id, int count);
+    void hideItems();
+    void showItem(PrimItem* item);
     void itemCheckState(QTreeWidgetItem* item, bool checkable, bool recursive = false);
     void treeCheckState(QTreeWidgetItem* item);
     void contextMenuEvent(QContextMenuEvent* event);
+    void headerMenu(const QPoint& pos);
+    void sortSection(int column);
+    void sortStageOrder();
+    void statisticsChanged();
+    void setStatistics(StatisticsCache* statistics);
+    void setStatisticsEnabled(bool enabled);
     void updateStage(UsdStageRefPtr stage);
     void updatePrims(const NoticeBatch& batch);
     void updateSelection(const QList<SdfPath>& paths);
@@ -73,6 +91,11 @@ public:
     void refreshParentBranch(const SdfPath& path);
     PrimItem* addItem(PrimItem* parent, const SdfPath& parentPath);
     void addChildren(PrimItem* parent, const SdfPath& parentPath);
+    void fetchChildren(PrimItem* item);
+    void updateChildIndicator(PrimItem* item, const UsdPrim& prim);
+    PrimItem* ensureItem(const SdfPath& path);
+    void removeItem(PrimItem* item);
+    void unindexItem(PrimItem* item);
     int parentDepth(const SdfPath& path) const;
     PrimItem* itemFromPath(const SdfPath& path) const;
     void clearDropIndicator();
@@ -89,9 +112,21 @@ public:
         int pending = 0;
         bool payloadEnabled = false;
         QString filter;
+        QSet<SdfPath> filterPaths;
+        bool filterApplied = false;
+        int searchId = 0;
+        QTimer filterTimer;
+        PrimIndex index;
+        PrimCache cache;
+        HierarchyCache hierarchy;
+        QPointer<StatisticsCache> statistics;
+        bool statisticsEnabled = false;
+        int sortColumn = -1;
+        Qt::SortOrder sortOrder = Qt::AscendingOrder;
         QList<SdfPath> loadPaths;
         QList<SdfPath> unloadPaths;
         QList<SdfPath> maskPaths;
+        QHash<SdfPath, PrimItem*> items;
         UsdStageRefPtr stage;
         QPointer<ViewContext> context;
         QPointer<StageTree> tree;
@@ -117,7 +152,25 @@ StageTreePrivate::init()
     d.tree->setDragDropMode(QAbstractItemView::DragDrop);
     d.tree->setDefaultDropAction(Qt::MoveAction);
 
+    // typing restarts the timer, the search runs once input settles
+    d.filterTimer.setSingleShot(true);
+    d.filterTimer.setInterval(150);
+    connect(&d.filterTimer, &QTimer::timeout, this, &StageTreePrivate::startSearch);
+    connect(&d.index, &PrimIndex::resultsReady, this, &StageTreePrivate::searchResults);
+    connect(&d.index, &PrimIndex::searchFinished, this, &StageTreePrivate::searchFinished);
+    connect(&d.cache, &PrimCache::rowsChanged, this, [this]() { d.tree->viewport()->update(); });
+    connect(&d.hierarchy, &HierarchyCache::changed, d.tree.data(), &StageTree::hierarchyChanged);
+
+    // sorting is explicit, rows stay in stage order until a header is clicked
+    d.tree->header()->setSectionsClickable(true);
+    d.tree->header()->setSortIndicatorShown(false);
+    d.tree->header()->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(d.tree->header(), &QHeaderView::sectionClicked, this, &StageTreePrivate::sortSection);
+    connect(d.tree->header(), &QHeaderView::customContextMenuRequested, this, &StageTreePrivate::headerMenu);
+
     connect(d.tree.data(), &StageTree::itemSelectionChanged, this, &StageTreePrivate::itemSelectionChanged);
+    connect(d.tree.data(), &StageTree::itemExpanded, this,
+            [this](QTreeWidgetItem* item) { fetchChildren(static_cast<PrimItem*>(item)); });
     connect(d.tree.data(), &StageTree::itemChanged, this, [this](QTreeWidgetItem* item, int column) {
         if (column == PrimItem::Name) {
             PrimItem* primItem = static_cast<PrimItem*>(item);
@@ -160,8 +213,10 @@ void
 StageTreePrivate::initTree()
 {
     const int topLevelCount = d.tree->topLevelItemCount();
-    for (int i = 0; i < topLevelCount; ++i)
+    for (int i = 0; i < topLevelCount; ++i) {
+        fetchChildren(static_cast<PrimItem*>(d.tree->topLevelItem(i)));
         d.tree->expandItem(d.tree->topLevelItem(i));
+    }
 }
 
 void
@@ -250,6 +305,14 @@ StageTreePrivate::close()
 {
     QSignalBlocker blocker(d.tree);
     d.stage = nullptr;
+    d.index.setStage(nullptr, nullptr);
+    d.cache.setStage(nullptr, nullptr);
+    d.hierarchy.setStage(nullptr, nullptr, false);
+    d.filterTimer.stop();
+    d.filterPaths.clear();
+    d.filterApplied = false;
+    d.searchId = 0;
+    d.items.clear();
     d.tree->clear();
     clearDropIndicator();
 }
@@ -296,72 +359,58 @@ StageTreePrivate::expandDepth(int targetDepth, const SdfPath& path)
     if (d.tree->topLevelItemCount() == 0)
         return;
 
-    d.tree->setUpdatesEnabled(false);
-
-    if (path.IsEmpty()) {
-        QTreeWidgetItem* root = d.tree->topLevelItem(0);
-
-        std::function<void(QTreeWidgetItem*, int)> expandNode = [&](QTreeWidgetItem* item, int depthValue) {
-            item->setExpanded(depthValue < targetDepth);
-            for (int i = 0; i < item->childCount(); ++i)
-                expandNode(item->child(i), depthValue + 1);
-        };
-        expandNode(root, 0);
-    }
-    else {
-        QTreeWidgetItem* item = itemFromPath(path);
-        if (!item) {
-            d.tree->setUpdatesEnabled(true);
+    PrimItem* item = static_cast<PrimItem*>(d.tree->topLevelItem(0));
+    if (!path.IsEmpty()) {
+        item = ensureItem(path);
+        if (!item || item->path() != path)
             return;
-        }
-
-        const int selectedDepth = depth(path);
-
-        QTreeWidgetItem* parent = item->parent();
-        int parentDepthValue = selectedDepth - 1;
-        while (parent) {
-            parent->setExpanded(parentDepthValue < targetDepth);
-            parent = parent->parent();
-            parentDepthValue--;
-        }
-
-        std::function<void(QTreeWidgetItem*, int)> expandNode = [&](QTreeWidgetItem* node, int depthValue) {
-            node->setExpanded(depthValue < targetDepth);
-            for (int i = 0; i < node->childCount(); ++i)
-                expandNode(node->child(i), depthValue + 1);
-        };
-        expandNode(item, selectedDepth);
     }
 
+    d.tree->setUpdatesEnabled(false);
+    const int itemDepth = depth(item->path());
+    QTreeWidgetItem* parent = item->parent();
+    int parentDepthValue = itemDepth - 1;
+    while (parent) {
+        parent->setExpanded(parentDepthValue < targetDepth);
+        parent = parent->parent();
+        parentDepthValue--;
+    }
+
+    // descendants change state while the item is collapsed, so the view lays out once
+    fetchDepth(item, itemDepth, targetDepth);
+    item->setExpanded(false);
+    for (int i = 0; i < item->childCount(); ++i)
+        expandItems(item->child(i), itemDepth + 1, targetDepth);
+    item->setExpanded(itemDepth < targetDepth);
+
     d.tree->setUpdatesEnabled(true);
 }
 
-int
-StageTreePrivate::maxDepth(const SdfPath& path) const
+void
+StageTreePrivate::fetchDepth(PrimItem* item, int depthValue, int targetDepth)
 {
-    QTreeWidgetItem* root = nullptr;
-    if (d.tree->topLevelItemCount() > 0)
-        root = d.tree->topLevelItem(0);
-    if (!root)
-        return 0;
-
-    std::function<int(QTreeWidgetItem*, int)> subtreeDepth = [&](QTreeWidgetItem* item, int currentDepth) {
-        int max = currentDepth;
-        for (int i = 0; i < item->childCount(); ++i)
-            max = std::max(max, subtreeDepth(item->child(i), currentDepth + 1));
-        return max;
-    };
+    // branches without prims below the target depth are not populated
+    if (depthValue >= targetDepth || (d.hierarchy.isReady() && d.hierarchy.maxDepth(item->path()) <= depthValue))
+        return;
 
-    if (path.IsEmpty())
-        return subtreeDepth(root, 0);
+    fetchChildren(item);
+    for (int i = 0; i < item->childCount(); ++i)
+        fetchDepth(static_cast<PrimItem*>(item->child(i)), depthValue + 1, targetDepth);
+}
 
-    QTreeWidgetItem* item = itemFromPath(path);
-    if (!item)
-        return subtreeDepth(root, 0);
+void
+StageTreePrivate::expandItems(QTreeWidgetItem* item, int depthValue, int targetDepth)
+{
+    for (int i = 0; i < item->childCount(); ++i)
+        expandItems(item->child(i), depthValue + 1, targetDepth);
+    item->setExpanded(depthValue < targetDepth);
+}
 
-    const int parentDepthValue = depth(path);
-    const int childDepth = subtreeDepth(item, 0);
-    return parentDepthValue + childDepth;
+int
+StageTreePrivate::maxDepth(const SdfPath& path) const
+{
+    // precomputed per stage, depth of the path itself until the cache is ready
+    return d.hierarchy.maxDepth(path);
 }
 
 int
@@ -370,16 +419,7 @@ StageTreePrivate::depth(const SdfPath& path) const
     if (path.IsEmpty())
         return 0;
 
-    QTreeWidgetItem* item = itemFromPath(path);
-    if (!item)
-        return 0;
-
-    int depthValue = 0;
-    while (item->parent()) {
-        depthValue++;
-        item = item->parent();
-    }
-    return depthValue;
+    return int(path.GetPathElementCount());
 }
 
 PrimItem*
@@ -388,6 +428,7 @@ StageTreePrivate::addItem(PrimItem* parent, const SdfPath& path)
     UsdStageRefPtr stage;
     bool isPayload = false;
     bool isLoaded = false;
+    bool hasChildren = false;
 
     {
         READ_LOCKER(locker, d.context->stageLock(), "stageLock");
@@ -395,13 +436,17 @@ StageTreePrivate::addItem(PrimItem* parent, const SdfPath& path)
         if (!stage)
             return nullptr;
 
+        const UsdPrim prim = stage->GetPrimAtPath(path);
         isPayload = d.payloadEnabled && stage::isPayload(stage, path);
         if (isPayload)
-            isLoaded = stage->GetPrimAtPath(path).IsLoaded();
+            isLoaded = prim.IsLoaded();
+        else
+            hasChildren = prim && !prim.GetAllChildren().empty();
     }
 
-    PrimItem* item = new PrimItem(parent, stage, path);
+    PrimItem* item = new PrimItem(parent, &d.cache, path);
     item->invalidate();
+    d.items.insert(path, item);
 
     Qt::ItemFlags flags = item->flags();
     flags |= Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled;
@@ -412,10 +457,13 @@ StageTreePrivate::addItem(PrimItem* parent, const SdfPath& path)
 
     if (isPayload) {
         item->setCheckState(0, isLoaded ? Qt::Checked : Qt::Unchecked);
+        item->setPopulated(true);
         return item;
     }
 
-    addChildren(item, path);
+    // children are created when the branch is first expanded
+    if (hasChildren)
+        item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
     return item;
 }
 
@@ -440,6 +488,66 @@ StageTreePrivate::addChildren(PrimItem* parent, const SdfPath& path)
         addItem(parent, childPath);
 }
 
+void
+StageTreePrivate::fetchChildren(PrimItem* item)
+{
+    if (!item || item->isPopulated())
+        return;
+
+    item->setPopulated(true);
+    item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+    {
+        READ_LOCKER(locker, d.context->stageLock(), "stageLock");
+        if (!d.stage || (d.payloadEnabled && stage::isPayload(d.stage, item->path())))
+            return;
+    }
+    addChildren(item, item->path());
+
+    if (d.sortColumn >= 0)
+        item->sortChildren(d.sortColumn, d.sortOrder);
+
+    if (d.filterApplied) {
+        for (int i = 0; i < item->childCount(); ++i) {
+            PrimItem* child = static_cast<PrimItem*>(item->child(i));
+            child->setHidden(!d.filterPaths.contains(child->path()));
+        }
+    }
+}
+
+void
+StageTreePrivate::updateChildIndicator(PrimItem* item, const UsdPrim& prim)
+{
+    bool hasChildren = false;
+    {
+        READ_LOCKER(locker, d.context->stageLock(), "stageLock");
+        hasChildren = prim && !prim.GetAllChildren().empty();
+    }
+    item->setChildIndicatorPolicy(hasChildren ? QTreeWidgetItem::ShowIndicator
+                                              : QTreeWidgetItem::DontShowIndicatorWhenChildless);
+}
+
+PrimItem*
+StageTreePrivate::ensureItem(const SdfPath& path)
+{
+    // creates the branches down to path, returns the deepest item that exists
+    if (path.IsEmpty() || d.tree->topLevelItemCount() == 0)
+        return nullptr;
+
+    PrimItem* item = static_cast<PrimItem*>(d.tree->topLevelItem(0));
+    if (path == SdfPath::AbsoluteRootPath())
+        return item;
+
+    for (const SdfPath& prefix : path.GetPrefixes()) {
+        fetchChildren(item);
+
+        PrimItem* child = itemFromPath(prefix);
+        if (!child)
+            break;
+        item = child;
+    }
+    return item;
+}
+
 void
 StageTreePrivate::toggleVisible(PrimItem* item)
 {
@@ -462,39 +570,93 @@ StageTreePrivate::toggleVisible(PrimItem* item)
 void
 StageTreePrivate::updateFilter()
 {
-    std::function<bool(QTreeWidgetItem*)> matchFilter = [&](QTreeWidgetItem* item) -> bool {
-        bool matches = false;
-        for (int col = 0; col < d.tree->columnCount(); ++col) {
-            if (item->text(col).contains(d.filter, Qt::CaseInsensitive)) {
-                matches = true;
-                break;
-            }
-        }
+    if (!d.filter.isEmpty()) {
+        d.filterTimer.start();
+        return;
+    }
 
-        bool childMatches = false;
-        for (int i = 0; i < item->childCount(); ++i) {
-            if (matchFilter(item->child(i)))
-                childMatches = true;
-        }
+    d.filterTimer.stop();
+    d.index.cancel();
+    d.searchId = 0;
+    d.filterPaths.clear();
+    d.filterApplied = false;
+    for (PrimItem* item : std::as_const(d.items))
+        item->setHidden(false);
+}
 
-        const bool visible = matches || childMatches;
-        item->setHidden(!visible);
-        return visible;
-    };
+void
+StageTreePrivate::startSearch()
+{
+    if (d.filter.isEmpty() || !d.stage)
+        return;
 
-    for (int i = 0; i < d.tree->topLevelItemCount(); ++i)
-        matchFilter(d.tree->topLevelItem(i));
+    // the current tree stays visible until the first results arrive
+    d.filterApplied = false;
+    d.searchId = d.index.search(d.filter);
+}
+
+void
+StageTreePrivate::searchResults(int id, const QList<SdfPath>& paths)
+{
+    if (id != d.searchId)
+        return;
+
+    SignalGuard::Scope guard(this);
+    d.tree->setUpdatesEnabled(false);
+    if (!d.filterApplied)
+        hideItems();
+
+    // create only the branches that lead to matching prims
+    for (const SdfPath& path : paths)
+        showItem(ensureItem(path));
+
+    d.tree->setUpdatesEnabled(true);
+}
+
+void
+StageTreePrivate::searchFinished(int id, int count)
+{
+    Q_UNUSED(count);
+    if (id != d.searchId)
+        return;
+
+    if (!d.filterApplied)
+        hideItems();
+}
+
+void
+StageTreePrivate::hideItems()
+{
+    d.filterApplied = true;
+    d.filterPaths.clear();
+    for (auto it = d.items.cbegin(); it != d.items.cend(); ++it) {
+        if (it.key() != SdfPath::AbsoluteRootPath())
+            it.value()->setHidden(true);
+    }
+}
+
+void
+StageTreePrivate::showItem(PrimItem* item)
+{
+    // stops at the first ancestor already shown by an earlier match
+    for (; item; item = static_cast<PrimItem*>(item->parent())) {
+        if (d.filterPaths.contains(item->path()))
+            break;
+        d.filterPaths.insert(item->path());
+        item->setHidden(false);
+    }
 }
 
 void
 StageTreePrivate::itemSelectionChanged()
 {
+    const QList<QTreeWidgetItem*> items = d.tree->selectedItems();
     QList<SdfPath> paths;
-    for (QTreeWidgetItem* baseItem : d.tree->selectedItems()) {
-        PrimItem* item = static_cast<PrimItem*>(baseItem);
-        const QString pathString = item->data(0, PrimItem::Path).toString();
-        if (!pathString.isEmpty())
-            paths.append(SdfPath(QStringToString(pathString)));
+    paths.reserve(items.size());
+    for (QTreeWidgetItem* baseItem : items) {
+        const SdfPath path = static_cast<PrimItem*>(baseItem)->path();
+        if (!path.IsEmpty())
+            paths.append(path);
     }
     d.context->run(new Command(selectPaths(paths)));
 }
@@ -920,6 +1082,139 @@ StageTreePrivate::contextMenuEvent(QContextMenuEvent* event)
         d.context->run(new Command(deletePaths(paths)));
 }
 
+void
+StageTreePrivate::headerMenu(const QPoint& pos)
+{
+    QMenu menu(d.tree.data());
+    QAction* showStatistics = menu.addAction("Show Statistics");
+    showStatistics->setCheckable(true);
+    showStatistics->setChecked(d.statisticsEnabled);
+    QAction* stageOrder = menu.addAction("Sort by Stage Order");
+    stageOrder->setEnabled(d.sortColumn >= 0);
+
+    QAction* chosen = menu.exec(d.tree->header()->mapToGlobal(pos));
+    if (chosen == showStatistics)
+        setStatisticsEnabled(showStatistics->isChecked());
+    else if (chosen == stageOrder)
+        sortStageOrder();
+}
+
+void
+StageTreePrivate::sortSection(int column)
+{
+    if (column == PrimItem::Vis)
+        return;
+
+    // statistics sort largest first, clicking the sorted column again flips the order
+    if (column == d.sortColumn)
+        d.sortOrder = d.sortOrder == Qt::AscendingOrder ? Qt::DescendingOrder : Qt::AscendingOrder;
+    else
+        d.sortOrder = column >= PrimItem::Prims ? Qt::DescendingOrder : Qt::AscendingOrder;
+
+    d.sortColumn = column;
+    d.tree->header()->setSortIndicatorShown(true);
+    d.tree->sortItems(d.sortColumn, d.sortOrder);
+}
+
+void
+StageTreePrivate::sortStageOrder()
+{
+    d.sortColumn = -1;
+    d.tree->header()->setSortIndicatorShown(false);
+    if (d.tree->topLevelItemCount() == 0)
+        return;
+
+    // only created items are indexed, children fetched later arrive in stage order
+    {
+        READ_LOCKER(locker, d.context->stageLock(), "stageLock");
+        if (!d.stage)
+            return;
+
+        std::function<void(PrimItem*)> indexChildren = [&](PrimItem* item) {
+            if (!item->isPopulated() || item->childCount() == 0)
+                return;
+
+            const UsdPrim prim = d.stage->GetPrimAtPath(item->path());
+            if (!prim)
+                return;
+
+            int index = 0;
+            for (const UsdPrim& child : prim.GetAllChildren()) {
+                if (PrimItem* childItem = itemFromPath(child.GetPath())) {
+                    childItem->setStageIndex(index);
+                    indexChildren(childItem);
+                }
+                ++index;
+            }
+        };
+        indexChildren(static_cast<PrimItem*>(d.tree->topLevelItem(0)));
+    }
+    // without a sort indicator items compare by stage index
+    d.tree->sortItems(PrimItem::Name, Qt::AscendingOrder);
+}
+
+void
+StageTreePrivate::statisticsChanged()
+{
+    // the cache is shared, changes made for other views are ignored while the columns are hidden
+    if (!d.statisticsEnabled)
+        return;
+
+    // rows move once the totals are final rather than while subtrees fill in
+    if (d.sortColumn >= PrimItem::Prims && d.statistics && d.statistics->isReady())
+        d.tree->sortItems(d.sortColumn, d.sortOrder);
+
+    d.tree->viewport()->update();
+}
+
+void
+StageTreePrivate::setStatistics(StatisticsCache* statistics)
+{
+    if (d.statistics == statistics)
+        return;
+
+    if (d.statistics) {
+        d.statistics->setEnabled(d.tree, false);
+        disconnect(d.statistics, nullptr, this, nullptr);
+    }
+    d.statistics = statistics;
+    if (d.statistics) {
+        connect(d.statistics, &StatisticsCache::changed, this, &StageTreePrivate::statisticsChanged);
+        d.statistics->setEnabled(d.tree, d.statisticsEnabled);
+    }
+    d.cache.setStatistics(d.statisticsEnabled ? d.statistics : nullptr);
+}
+
+void
+StageTreePrivate::setStatisticsEnabled(bool enabled)
+{
+    if (d.statisticsEnabled == enabled)
+        return;
+
+    if (!enabled && d.sortColumn >= PrimItem::Prims)
+        sortStageOrder();
+
+    d.statisticsEnabled = enabled;
+    if (d.statistics)
+        d.statistics->setEnabled(d.tree, enabled);
+    d.cache.setStatistics(enabled ? d.statistics : nullptr);
+    if (!enabled) {
+        d.tree->setColumnCount(PrimItem::Vis + 1);
+        return;
+    }
+
+    d.tree->setColumnCount(PrimItem::PayloadSize + 1);
+    QTreeWidgetItem* headerItem = d.tree->headerItem();
+    headerItem->setText(PrimItem::Prims, "Prims");
+    headerItem->setText(PrimItem::Points, "Points");
+    headerItem->setText(PrimItem::Faces, "Faces");
+    headerItem->setText(PrimItem::PayloadSize, "Payload");
+    for (int column = PrimItem::Prims; column <= PrimItem::PayloadSize; ++column) {
+        d.tree->header()->setSectionResizeMode(column, QHeaderView::Interactive);
+        d.tree->setColumnWidth(column, 80);
+    }
+}
+
 void
 StageTreePrivate::updateStage(UsdStageRefPtr stage)
 {
@@ -929,20 +1224,24 @@ StageTreePrivate::updateStage(UsdStageRefPtr stage)
     if (!stage)
         return;
 
+    d.index.setStage(stage, d.context->stageLock());
+    d.cache.setStage(stage, d.context->stageLock());
+    d.hierarchy.setStage(stage, d.context->stageLock(), d.payloadEnabled);
+
     UsdPrim prim;
     {
         READ_LOCKER(locker, d.context->stageLock(), "stageLock");
         prim = stage->GetPseudoRoot();
     }
 
-    PrimItem* rootItem = new PrimItem(d.tree.data(), stage, prim.GetPath());
+    PrimItem* rootItem = new PrimItem(d.tree.data(), &d.cache, prim.GetPath());
+    d.items.insert(prim.GetPath(), rootItem);
 
     Qt::ItemFlags flags = rootItem->flags();
     flags |= Qt::ItemIsDropEnabled;
     rootItem->setFlags(flags);
 
     itemCheckState(rootItem, false, false);
-    addChildren(rootItem, prim.GetPath());
     initTree();
 
     if (d.payloadEnabled)
@@ -955,6 +1254,12 @@ StageTreePrivate::syncDirectChildrenOnly(PrimItem* parentItem, const UsdPrim& pa
     if (!parentItem || !parentPrim)
         return;
 
+    if (!parentItem->isPopulated()) {
+        updateChildIndicator(parentItem, parentPrim);
+        parentItem->invalidate();
+        return;
+    }
+
     QList<SdfPath> ordered;
     QSet<QString> stageSet;
 
@@ -982,7 +1287,7 @@ StageTreePrivate::syncDirectChildrenOnly(PrimItem* parentItem, const UsdPrim& pa
 
     for (auto it = existing.begin(); it != existing.end(); ++it) {
         if (!stageSet.contains(it.key()))
-            delete it.value();
+            removeItem(it.value());
     }
 
     existing.clear();
@@ -1064,6 +1369,9 @@ StageTreePrivate::syncDirectChildrenOnly(PrimItem* parentItem, const UsdPrim& pa
         }
     }
 
+    if (d.sortColumn >= 0)
+        parentItem->sortChildren(d.sortColumn, d.sortOrder);
+
     parentItem->invalidate();
 }
 
@@ -1197,6 +1505,24 @@ StageTreePrivate::updatePrims(const NoticeBatch& batch)
         }
     }
 
+    // resyncs add, remove or rename prims, the index patches those subtrees and an active filter reruns
+    QList<SdfPath> resyncedPaths;
+    for (const NoticeEntry& entry : batch.entries) {
+        if (entry.changedInfoOnly)
+            continue;
+        if (entry.path.IsAbsoluteRootOrPrimPath())
+            resyncedPaths.append(entry.path);
+        if (entry.associatedPath.IsAbsoluteRootOrPrimPath())
+            resyncedPaths.append(entry.associatedPath);
+    }
+
+    if (!resyncedPaths.isEmpty()) {
+        d.hierarchy.invalidate(resyncedPaths);
+        d.index.invalidate(resyncedPaths);
+        if (!d.filter.isEmpty())
+            d.filterTimer.start();
+    }
+
     d.tree->setUpdatesEnabled(true);
     d.tree->update();
 }
@@ -1234,7 +1560,8 @@ StageTreePrivate::updatePrim(const SdfPath& path)
             primItem->setCheckState(0, want);
 
         while (primItem->childCount() > 0)
-            delete primItem->child(0);
+            removeItem(static_cast<PrimItem*>(primItem->child(0)));
+        primItem->setPopulated(true);
     }
 }
 
@@ -1258,7 +1585,7 @@ StageTreePrivate::invalidatePrimImpl(const SdfPath& path, bool refreshParent)
         PrimItem* parentItem = itemFromPath(parentPath);
 
         if (primItem)
-            delete primItem;
+            removeItem(primItem);
 
         if (refreshParent && parentItem) {
             UsdPrim parentPrim;
@@ -1280,6 +1607,11 @@ StageTreePrivate::invalidatePrimImpl(const SdfPath& path, bool refreshParent)
         if (!parentItem)
             return;
 
+        if (!parentItem->isPopulated()) {
+            updateChildIndicator(parentItem, prim.GetParent());
+            return;
+        }
+
         primItem = addItem(parentItem, primPath);
         if (!primItem)
             return;
@@ -1317,7 +1649,8 @@ StageTreePrivate::invalidateSubtree(PrimItem* item, const UsdPrim& prim)
             item->setCheckState(0, want);
 
         while (item->childCount() > 0)
-            delete item->child(0);
+            removeItem(static_cast<PrimItem*>(item->child(0)));
+        item->setPopulated(true);
 
         return;
     }
@@ -1337,6 +1670,11 @@ StageTreePrivate::invalidateChildren(PrimItem* parentItem, const UsdPrim& prim)
     if (!parentItem || !prim)
         return;
 
+    if (!parentItem->isPopulated()) {
+        updateChildIndicator(parentItem, prim);
+        return;
+    }
+
     QHash<QString, PrimItem*> existing;
     existing.reserve(parentItem->childCount());
 
@@ -1362,7 +1700,7 @@ StageTreePrivate::invalidateChildren(PrimItem* parentItem, const UsdPrim& prim)
 
     for (auto it = existing.begin(); it != existing.end(); ++it) {
         if (!stageSet.contains(it.key()))
-            delete it.value();
+            removeItem(it.value());
     }
 
     existing.clear();
@@ -1439,7 +1777,7 @@ StageTreePrivate::invalidateChildren(PrimItem* parentItem, const UsdPrim& prim)
         }
 
         if (!childPrim) {
-            delete childItem;
+            removeItem(childItem);
             --i;
             continue;
         }
@@ -1455,6 +1793,8 @@ StageTreePrivate::remapSubtreePaths(const SdfPath& fromPath, const SdfPath& toPa
     if (!rootItem)
         return false;
 
+    // unindex the whole subtree first so remapped paths never collide with old ones
+    QList<PrimItem*> remapped;
     std::function<void(PrimItem*)> remap = [&](PrimItem* item) {
         if (!item)
             return;
@@ -1462,7 +1802,10 @@ StageTreePrivate::remapSubtreePaths(const SdfPath& fromPath, const SdfPath& toPa
         const SdfPath oldItemPath = item->path();
         if (!oldItemPath.IsEmpty() && (oldItemPath == fromPath || oldItemPath.HasPrefix(fromPath))) {
             const SdfPath newItemPath = oldItemPath.ReplacePrefix(fromPath, toPath);
+            if (d.items.value(oldItemPath) == item)
+                d.items.remove(oldItemPath);
             item->setPath(newItemPath);
+            remapped.append(item);
         }
 
         item->invalidate();
@@ -1472,6 +1815,8 @@ StageTreePrivate::remapSubtreePaths(const SdfPath& fromPath, const SdfPath& toPa
     };
 
     remap(rootItem);
+    for (PrimItem* item : remapped)
+        d.items.insert(item->path(), item);
     return true;
 }
 
@@ -1506,61 +1851,60 @@ void
 StageTreePrivate::updateSelection(const QList<SdfPath>& paths)
 {
     SignalGuard::Scope guard(this);
-    const QSet<SdfPath> selectedSet(paths.begin(), paths.end());
-
-    std::function<void(QTreeWidgetItem*)> selectItems = [&](QTreeWidgetItem* baseItem) {
-        PrimItem* primItem = static_cast<PrimItem*>(baseItem);
-        const QString pathString = primItem->data(0, PrimItem::Path).toString();
-        if (!pathString.isEmpty()) {
-            const SdfPath itemPath(QStringToString(pathString));
-            bool isSelected = selectedSet.contains(itemPath);
-
-            if (!isSelected && d.payloadEnabled && primItem->childCount() == 0) {
-                for (const SdfPath& path : selectedSet) {
-                    if (path.HasPrefix(itemPath) && path != itemPath) {
-                        isSelected = true;
-                        break;
-                    }
-                }
-            }
+    QSet<QTreeWidgetItem*> selected;
+    selected.reserve(paths.size());
+    for (const SdfPath& path : paths) {
+        PrimItem* item = itemFromPath(path);
+        if (!item) {
+            // selection can land in branches that were never expanded
+            item = ensureItem(path);
+            if (!item || item->path() == SdfPath::AbsoluteRootPath())
+                continue;
 
-            primItem->setSelected(isSelected);
+            // payload leaves stand in for their selected descendants
+            if (item->path() != path && !(d.payloadEnabled && item->childCount() == 0))
+                continue;
         }
+        selected.insert(item);
+    }
 
-        for (int i = 0; i < primItem->childCount(); ++i)
-            selectItems(primItem->child(i));
-    };
-
-    for (int i = 0; i < d.tree->topLevelItemCount(); ++i)
-        selectItems(d.tree->topLevelItem(i));
-
+    // only the difference to the current selection is applied
+    QList<QTreeWidgetItem*> deselected;
+    for (QTreeWidgetItem* item : d.tree->selectedItems()) {
+        if (!selected.remove(item))
+            deselected.append(item);
+    }
+    d.tree->selectItems(deselected, QItemSelectionModel::Deselect);
+    d.tree->selectItems(QList<QTreeWidgetItem*>(selected.cbegin(), selected.cend()), QItemSelectionModel::Select);
     d.tree->update();
 }
 
 PrimItem*
 StageTreePrivate::itemFromPath(const SdfPath& path) const
 {
-    std::function<PrimItem*(PrimItem*)> find = [&](PrimItem* item) -> PrimItem* {
-        if (!item)
-            return nullptr;
-
-        if (item->path() == path)
-            return item;
+    return d.items.value(path, nullptr);
+}
 
-        for (int i = 0; i < item->childCount(); ++i) {
-            if (PrimItem* found = find(static_cast<PrimItem*>(item->child(i))))
-                return found;
-        }
+void
+StageTreePrivate::removeItem(PrimItem* item)
+{
+    if (!item)
+        return;
 
-        return nullptr;
-    };
+    unindexItem(item);
+    delete item;
+}
 
-    for (int i = 0; i < d.tree->topLevelItemCount(); ++i) {
-        if (PrimItem* found = find(static_cast<PrimItem*>(d.tree->topLevelItem(i))))
-            return found;
-    }
+void
+StageTreePrivate::unindexItem(PrimItem* item)
+{
+    // deleting an item deletes its subtree, so every descendant leaves the index too
+    for (int i = 0; i < item->childCount(); ++i)
+        unindexItem(static_cast<PrimItem*>(item->child(i)));
 
-    return nullptr;
+    auto it = d.items.find(item->path());
+    if (it != d.items.end() && it.value() == item)
+        d.items.erase(it);
 }
 
 StageTree::StageTree(QWidget* parent)
@@ -1582,8 +1926,10 @@ StageTree::context() const
 void
 StageTree::setContext(ViewContext* context)
 {
-    if (p->d.context != context)
+    if (p->d.context != context) {
         p->d.context = context;
+        p->setStatistics(context ? context->statisticsCache() : nullptr);
+    }
 }
 
 void
@@ -1637,6 +1983,18 @@ StageTree::setFilter(const QString& filter)
     }
 }
 
+bool
+StageTree::statisticsEnabled() const
+{
+    return p->d.statisticsEnabled;
+}
+
+void
+StageTree::setStatisticsEnabled(bool enabled)
+{
+    p->setStatisticsEnabled(enabled);
+}
+
 bool
 StageTree::payloadEnabled() const
 {
@@ -1862,25 +2220,7 @@ StageTree::dropEvent(QDropEvent* event)
     }
 
     if (fromPath.GetParentPath() == newParentPath) {
-        QTreeWidgetItem* sourceItem = nullptr;
-
-        std::function<QTreeWidgetItem*(QTreeWidgetItem*)> findItem = [&](QTreeWidgetItem* item) -> QTreeWidgetItem* {
-            if (!item)
-                return nullptr;
-
-            if (item->data(0, PrimItem::Path).toString() == fromPathString)
-                return item;
-
-            for (int i = 0; i < item->childCount(); ++i) {
-                if (QTreeWidgetItem* found = findItem(item->child(i)))
-                    return found;
-            }
-            return nullptr;
-        };
-
-        for (int i = 0; i < topLevelItemCount() && !sourceItem; ++i)
-            sourceItem = findItem(topLevelItem(i));
-
+        QTreeWidgetItem* sourceItem = p->itemFromPath(fromPath);
         if (sourceItem) {
             QTreeWidgetItem* oldParentItem = sourceItem->parent();
             if (oldParentItem) {
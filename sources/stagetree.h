@@ -90,6 +90,9 @@ public:
 
     /**
       * @brief Returns the maximum depth reachable from a node.
+      *
+      * Read from statistics precomputed when the stage is set, see
+      * hierarchyChanged().
       */
     int maxDepth(const SdfPath& path = SdfPath()) const;
 
@@ -106,12 +109,37 @@ public:
     /**
      * @brief Sets a filter used to restrict visible prims.
      *
-     * @param filter Filter string applied to prim names.
+     * The search is debounced and runs against a background prim index,
+     * matching branches are shown as results arrive. See PrimIndex for
+     * the glob, regex, type and payload-state syntax.
+     *
+     * @param filter Filter query applied to prim names and paths.
      */
     void setFilter(const QString& filter);
 
     ///@}
 
+    /** @name Statistics */
+    ///@{
+
+    /**
+     * @brief Returns whether subtree statistics columns are shown.
+     */
+    bool statisticsEnabled() const;
+
+    /**
+     * @brief Shows or hides the subtree statistics columns.
+     *
+     * Descendant prims, mesh points, mesh faces and payload asset size
+     * are read from the context's shared StatisticsCache and fill in as
+     * subtrees finish. Also toggled from the header context menu.
+     *
+     * @param enabled Statistics columns state.
+     */
+    void setStatisticsEnabled(bool enabled);
+
+    ///@}
+
     /** @name Payload Control */
     ///@{
 
@@ -183,6 +211,11 @@ Q_SIGNALS:
      */
     void primSelectionChanged(const QList<SdfPath>& paths);
 
+    /**
+     * @brief Emitted when the precomputed depth statistics are updated.
+     */
+    void hierarchyChanged();
+
 protected:
     /** @name Event Handling */
     ///@{
@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#include "statisticscache.h"
+#include "qtutils.h"
+#include "subtreecache.h"
+#include "usdutils.h"
+#include <QFileInfo>
+#include <QHash>
+#include <QPointer>
+#include <pxr/usd/ar/resolver.h>
+#include <pxr/usd/sdf/layerUtils.h>
+#include <pxr/usd/sdf/primSpec.h>
+#include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usdGeom/tokens.h>
+#include <string>
+#include <unordered_map>
+
+namespace usdviewer {
+class StatisticsCachePrivate {
+public:
+    struct Policy {
+        typedef StatisticsCache::Entry Entry;
+        Entry compute(const UsdPrim& prim);
+        bool isExpanded(const UsdPrim&) const { return true; }
+        static void add(Entry& entry, const Entry& child);
+        static bool isEmpty(const Entry& entry);
+        static Entry empty(const SdfPath&) { return Entry(); }
+
+        // payload asset sizes, looked up once per task
+        std::unordered_map<std::string, qint64> sizes;
+    };
+
+    void init();
+
+public:
+    struct Data {
+        SubtreeCache<Policy> subtrees { true };  // prims with non-zero statistics only
+        QHash<const QObject*, QMetaObject::Connection> owners;
+        QPointer<StatisticsCache> cache;
+    };
+    Data d;
+};
+
+void
+StatisticsCachePrivate::init()
+{
+    // disabled until an owner enables it, results are published as subtrees finish
+    d.subtrees.setEnabled(false);
+    QPointer<StatisticsCache> cache = d.cache;
+    d.subtrees.setNotify([cache]() {
+        if (!cache)
+            return;
+
+        QMetaObject::invokeMethod(
+            cache,
+            [cache]() {
+                if (cache)
+                    Q_EMIT cache->changed();
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+StatisticsCachePrivate::Policy::Entry
+StatisticsCachePrivate::Policy::compute(const UsdPrim& prim)
+{
+    Entry entry;
+    // classes and overs are not part of the scene, Traverse() skips them as well
+    if (prim.IsPseudoRoot() || !prim.IsDefined() || prim.IsAbstract())
+        return entry;
+
+    // same per-prim numbers as the render view statistics
+    stage::Statistics statistics;
+    stage::accumulateStatistics(prim, statistics);
+    entry.prims = qint64(statistics.prims);
+    entry.meshes = qint64(statistics.meshes);
+    entry.xforms = qint64(statistics.xforms);
+    entry.payloads = qint64(statistics.payloads);
+    entry.instances = qint64(statistics.instances);
+    entry.vertices = qint64(statistics.vertices);
+    entry.normals = qint64(statistics.normals);
+    entry.faces = qint64(statistics.faces);
+
+    if (!prim.HasAuthoredPayloads())
+        return entry;
+
+    for (const SdfPrimSpecHandle& spec : prim.GetPrimStack()) {
+        if (!spec)
+            continue;
+
+        for (const SdfPayload& payload : spec->GetPayloadList().GetAppliedItems()) {
+            if (payload.GetAssetPath().empty())
+                continue;
+
+            const std::string assetPath = SdfComputeAssetPathRelativeToLayer(spec->GetLayer(),
+                                                                             payload.GetAssetPath());
+            auto it = sizes.find(assetPath);
+            if (it == sizes.end()) {
+                const std::string resolved = ArGetResolver().Resolve(assetPath);
+                const qint64 size = resolved.empty() ? 0 : QFileInfo(qt::StringToQString(resolved)).size();
+                it = sizes.emplace(assetPath, size).first;
+            }
+            entry.payloadBytes += it->second;
+        }
+    }
+    return entry;
+}
+
+void
+StatisticsCachePrivate::Policy::add(Entry& entry, const Entry& child)
+{
+    entry.prims += child.prims;
+    entry.descendants += child.prims;
+    entry.meshes += child.meshes;
+    entry.xforms += child.xforms;
+    entry.payloads += child.payloads;
+    entry.instances += child.instances;
+    entry.vertices += child.vertices;
+    entry.normals += child.normals;
+    entry.faces += child.faces;
+    entry.payloadBytes += child.payloadBytes;
+}
+
+bool
+StatisticsCachePrivate::Policy::isEmpty(const Entry& entry)
+{
+    // counts other than prims and payload bytes only occur on active, loaded prims
+    return entry.prims == 0 && entry.payloadBytes == 0;
+}
+
+StatisticsCache::StatisticsCache(QObject* parent)
+    : QObject(parent)
+    , p(new StatisticsCachePrivate())
+{
+    p->d.cache = this;
+    p->init();
+}
+
+StatisticsCache::~StatisticsCache() = default;
+
+void
+StatisticsCache::setStage(UsdStageRefPtr stage, QReadWriteLock* lock)
+{
+    p->d.subtrees.setStage(stage, lock);
+}
+
+bool
+StatisticsCache::isEnabled() const
+{
+    return p->d.subtrees.isEnabled();
+}
+
+bool
+StatisticsCache::isEnabled(const QObject* owner) const
+{
+    return p->d.owners.contains(owner);
+}
+
+void
+StatisticsCache::setEnabled(const QObject* owner, bool enabled)
+{
+    if (!owner || p->d.owners.contains(owner) == enabled)
+        return;
+
+    if (enabled) {
+        p->d.owners.insert(owner, connect(owner, &QObject::destroyed, this, [this, owner]() {
+            setEnabled(owner, false);
+        }));
+    }
+    else {
+        disconnect(p->d.owners.take(owner));
+    }
+    p->d.subtrees.setEnabled(!p->d.owners.isEmpty());
+}
+
+void
+StatisticsCache::invalidate(const QList<SdfPath>& paths)
+{
+    p->d.subtrees.invalidate(paths);
+}
+
+void
+StatisticsCache::invalidate(const NoticeBatch& batch)
+{
+    // mesh counts change without a resync when topology or normals are edited
+    static const TfToken normalsPrimvar("primvars:normals");
+    QList<SdfPath> paths;
+    for (const NoticeEntry& entry : batch.entries) {
+        if (!entry.changedInfoOnly || entry.resolvedAssetPathsResynced) {
+            if (entry.path.IsAbsoluteRootOrPrimPath())
+                paths.append(entry.path);
+            if (entry.associatedPath.IsAbsoluteRootOrPrimPath())
+                paths.append(entry.associatedPath);
+            continue;
+        }
+        if (!entry.path.IsPropertyPath())
+            continue;
+
+        const TfToken& name = entry.path.GetNameToken();
+        if (name == UsdGeomTokens->points || name == UsdGeomTokens->faceVertexCounts || name == UsdGeomTokens->normals
+            || name == normalsPrimvar)
+            paths.append(entry.path.GetPrimPath());
+    }
+    invalidate(paths);
+}
+
+bool
+StatisticsCache::isReady() const
+{
+    return p->d.subtrees.isReady();
+}
+
+bool
+StatisticsCache::isComputed(const SdfPath& path) const
+{
+    return p->d.subtrees.isComputed(path);
+}
+
+StatisticsCache::Entry
+StatisticsCache::entry(const SdfPath& path) const
+{
+    return p->d.subtrees.entry(path);
+}
+
+StatisticsCache::Entry
+StatisticsCache::total(const QList<SdfPath>& paths) const
+{
+    Entry total;
+    for (const Entry& entry : p->d.subtrees.entries(path::topLevelPaths(paths)))
+        StatisticsCachePrivate::Policy::add(total, entry);
+    return total;
+}
+
+}  // namespace usdviewer
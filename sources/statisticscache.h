@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#pragma once
+
+#include "notice.h"
+#include <QList>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QScopedPointer>
+#include <pxr/usd/usd/stage.h>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace usdviewer {
+
+class StatisticsCachePrivate;
+
+/**
+ * @class StatisticsCache
+ * @brief Scene statistics aggregated by subtree.
+ *
+ * Sums the per-prim statistics of stage::accumulateStatistics() over
+ * every subtree, together with the on-disk size of payload assets. The
+ * table is computed on worker threads while any owner has it enabled,
+ * so views showing statistics share one table. Independent subtrees
+ * are computed in parallel, and each finished subtree is published at
+ * once so results fill in progressively. Resynced paths and mesh topology
+ * changes passed to invalidate() are recomputed with their ancestors,
+ * so totals for the stage or a selection are lookups, not traversals.
+ *
+ * Lookups are thread-safe, other methods must be called from the GUI
+ * thread.
+ */
+class StatisticsCache : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @struct Entry
+     * @brief Statistics of a prim and everything below it.
+     */
+    struct Entry {
+        qint64 prims = 0;         ///< Active, loaded prims including the prim itself.
+        qint64 descendants = 0;   ///< Active, loaded prims below the prim.
+        qint64 meshes = 0;        ///< UsdGeomMesh prims.
+        qint64 xforms = 0;        ///< UsdGeomXform prims.
+        qint64 payloads = 0;      ///< Prims with payloads.
+        qint64 instances = 0;     ///< Instanceable prims.
+        qint64 vertices = 0;      ///< Mesh points.
+        qint64 normals = 0;       ///< Mesh normals.
+        qint64 faces = 0;         ///< Mesh faces.
+        qint64 payloadBytes = 0;  ///< File size of payload assets, per payload arc.
+    };
+
+public:
+    /**
+     * @brief Constructs an empty, disabled cache.
+     *
+     * @param parent Optional parent object.
+     */
+    StatisticsCache(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroys the StatisticsCache instance.
+     */
+    ~StatisticsCache() override;
+
+    /**
+     * @brief Sets the stage to describe and the lock guarding it.
+     */
+    void setStage(UsdStageRefPtr stage, QReadWriteLock* lock);
+
+    /**
+     * @brief Returns whether statistics are computed.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Returns whether @p owner has enabled computation.
+     */
+    bool isEnabled(const QObject* owner) const;
+
+    /**
+     * @brief Enables or disables computation on behalf of @p owner.
+     *
+     * Statistics are computed while at least one owner has them enabled,
+     * the table is dropped when the last one disables them or is
+     * destroyed.
+     */
+    void setEnabled(const QObject* owner, bool enabled);
+
+    /**
+     * @brief Recomputes the subtrees of changed prim paths.
+     */
+    void invalidate(const QList<SdfPath>& paths);
+
+    /**
+     * @brief Recomputes the subtrees affected by a notice batch.
+     *
+     * Covers resyncs, asset path resyncs and edits to mesh points,
+     * face vertex counts and normals.
+     */
+    void invalidate(const NoticeBatch& batch);
+
+    /**
+     * @brief Returns true once the whole stage has been computed.
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Returns true if statistics for @p path are available.
+     */
+    bool isComputed(const SdfPath& path) const;
+
+    /**
+     * @brief Returns the statistics of @p path and its descendants.
+     */
+    Entry entry(const SdfPath& path) const;
+
+    /**
+     * @brief Returns the summed statistics of prim hierarchies.
+     *
+     * Paths below other paths in the list are counted once.
+     */
+    Entry total(const QList<SdfPath>& paths) const;
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted when computed statistics have been published.
+     */
+    void changed();
+
+private:
+    Q_DISABLE_COPY_MOVE(StatisticsCache)
+    QScopedPointer<StatisticsCachePrivate> p;
+};
+
+}  // namespace usdviewer
@@ -0,0 +1,479 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#pragma once
+
+#include "tracelocks.h"
+#include "usdutils.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QThreadPool>
+#include <pxr/base/work/loops.h>
+#include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usd/stage.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace usdviewer {
+
+/**
+ * @class SubtreeCache
+ * @brief Per-prim table aggregated over subtrees on a worker thread.
+ *
+ * Shared by the caches that sum a value over every subtree of a stage.
+ * The upper levels are split into independent subtrees computed in
+ * parallel, then folded children before parents. Paths passed to
+ * invalidate() are recomputed in the background together with their
+ * ancestors, so lookups never traverse the stage.
+ *
+ * The policy describes the value:
+ * - Entry, the aggregated value of a prim and its subtree.
+ * - Entry compute(const UsdPrim&), the value of the prim alone.
+ * - bool isExpanded(const UsdPrim&) const, whether children are included.
+ * - static void add(Entry&, const Entry&), adds a child subtree.
+ * - static bool isEmpty(const Entry&), entries that are not stored.
+ * - static Entry empty(const SdfPath&), the value of prims not stored.
+ *
+ * Each parallel task works on its own copy of the policy, so it may
+ * hold scratch data such as file size lookups.
+ *
+ * Lookups are thread-safe, other methods must be called from the GUI
+ * thread.
+ */
+template<typename Policy>
+class SubtreeCache {
+public:
+    typedef typename Policy::Entry Entry;
+    typedef QHash<SdfPath, Entry> Entries;
+
+    /**
+     * @brief Constructs an empty, enabled cache.
+     *
+     * @param progressive Notify while the table is built, not only once done.
+     */
+    explicit SubtreeCache(bool progressive = false);
+
+    /**
+     * @brief Stops a running worker at its next generation check.
+     */
+    ~SubtreeCache();
+
+    /**
+     * @brief Sets the function called, from the worker, when entries are published.
+     */
+    void setNotify(const std::function<void()>& notify);
+
+    /**
+     * @brief Sets the stage to describe and starts building the table.
+     */
+    void setStage(UsdStageRefPtr stage, QReadWriteLock* lock, const Policy& policy = Policy());
+
+    /**
+     * @brief Returns whether the table is computed.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Enables computation, disabling drops the table.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Recomputes the subtrees of changed prim paths.
+     */
+    void invalidate(const QList<SdfPath>& paths);
+
+    /**
+     * @brief Returns true once the whole stage has been computed.
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Returns true if the subtree of @p path has been computed.
+     */
+    bool isComputed(const SdfPath& path) const;
+
+    /**
+     * @brief Returns the entry of @p path.
+     */
+    Entry entry(const SdfPath& path) const;
+
+    /**
+     * @brief Returns the entries of paths, read at once.
+     */
+    QList<Entry> entries(const QList<SdfPath>& paths) const;
+
+private:
+    struct State {
+        QMutex mutex;
+        QMutex updateMutex;
+        Entries entries;  // non-empty entries only
+        QSet<SdfPath> computed;
+        UsdStageRefPtr stage;
+        QReadWriteLock* lock = nullptr;
+        Policy policy;
+        bool enabled = true;
+        quint64 generation = 0;
+        bool ready = false;
+        bool running = false;
+        QList<SdfPath> pending;
+    };
+
+    void start();
+    void reset();
+    static void process(const std::shared_ptr<State>& state, const std::function<void()>& notify, bool progressive);
+    static void build(const std::shared_ptr<State>& state, UsdStageRefPtr stage, QReadWriteLock* lock,
+                      const Policy& policy, quint64 generation, const std::function<void()>& notify, bool progressive);
+    static void update(const std::shared_ptr<State>& state, UsdStageRefPtr stage, QReadWriteLock* lock,
+                       const Policy& policy, const QList<SdfPath>& paths, quint64 generation);
+    static Entry computeSubtree(Policy& policy, const UsdPrim& prim, Entries& entries, std::vector<SdfPath>* empty);
+    static Entry fold(Policy& policy, const UsdPrim& prim, const Entries& entries);
+    static Entry lookup(const Entries& entries, const SdfPath& path);
+
+    struct Data {
+        std::shared_ptr<State> state;
+        std::function<void()> notify;
+        bool progressive = false;
+    };
+    Data d;
+
+    Q_DISABLE_COPY_MOVE(SubtreeCache)
+};
+
+template<typename Policy>
+SubtreeCache<Policy>::SubtreeCache(bool progressive)
+{
+    d.state = std::make_shared<State>();
+    d.progressive = progressive;
+}
+
+template<typename Policy>
+SubtreeCache<Policy>::~SubtreeCache()
+{
+    // a running worker holds the state, it stops at the next generation check
+    QMutexLocker locker(&d.state->mutex);
+    d.state->stage = nullptr;
+    d.state->generation++;
+}
+
+template<typename Policy>
+void
+SubtreeCache<Policy>::setNotify(const std::function<void()>& notify)
+{
+    d.notify = notify;
+}
+
+template<typename Policy>
+void
+SubtreeCache<Policy>::setStage(UsdStageRefPtr stage, QReadWriteLock* lock, const Policy& policy)
+{
+    QMutexLocker locker(&d.state->mutex);
+    d.state->stage = stage;
+    d.state->lock = lock;
+    d.state->policy = policy;
+    reset();
+    start();
+}
+
+template<typename Policy>
+bool
+SubtreeCache<Policy>::isEnabled() const
+{
+    QMutexLocker locker(&d.state->mutex);
+    return d.state->enabled;
+}
+
+template<typename Policy>
+void
+SubtreeCache<Policy>::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&d.state->mutex);
+    if (d.state->enabled == enabled)
+        return;
+
+    d.state->enabled = enabled;
+    reset();
+    start();
+}
+
+template<typename Policy>
+void
+SubtreeCache<Policy>::invalidate(const QList<SdfPath>& paths)
+{
+    QMutexLocker locker(&d.state->mutex);
+    if (!d.state->stage || !d.state->enabled || paths.isEmpty())
+        return;
+
+    d.state->pending.append(paths);
+    start();
+}
+
+template<typename Policy>
+bool
+SubtreeCache<Policy>::isReady() const
+{
+    QMutexLocker locker(&d.state->mutex);
+    return d.state->ready;
+}
+
+template<typename Policy>
+bool
+SubtreeCache<Policy>::isComputed(const SdfPath& path) const
+{
+    QMutexLocker locker(&d.state->mutex);
+    if (d.state->ready)
+        return true;
+    if (d.state->computed.isEmpty())
+        return false;
+
+    for (SdfPath prefix = path; !prefix.IsEmpty(); prefix = prefix.GetParentPath()) {
+        if (d.state->computed.contains(prefix))
+            return true;
+    }
+    return false;
+}
+
+template<typename Policy>
+typename SubtreeCache<Policy>::Entry
+SubtreeCache<Policy>::entry(const SdfPath& path) const
+{
+    QMutexLocker locker(&d.state->mutex);
+    return lookup(d.state->entries, path);
+}
+
+template<typename Policy>
+QList<typename SubtreeCache<Policy>::Entry>
+SubtreeCache<Policy>::entries(const QList<SdfPath>& paths) const
+{
+    QList<Entry> entries;
+    entries.reserve(paths.size());
+    QMutexLocker locker(&d.state->mutex);
+    for (const SdfPath& path : paths)
+        entries.append(lookup(d.state->entries, path));
+    return entries;
+}
+
+template<typename Policy>
+void
+SubtreeCache<Policy>::start()
+{
+    // called with the state mutex held, a running worker picks up new work itself
+    if (d.state->running || !d.state->stage || !d.state->enabled)
+        return;
+
+    d.state->running = true;
+    std::shared_ptr<State> state = d.state;
+    std::function<void()> notify = d.notify;
+    const bool progressive = d.progressive;
+    QThreadPool::globalInstance()->start([state, notify, progressive]() { process(state, notify, progressive); });
+}
+
+template<typename Policy>
+void
+SubtreeCache<Policy>::reset()
+{
+    // called with the state mutex held
+    d.state->generation++;
+    d.state->ready = false;
+    d.state->entries.clear();
+    d.state->computed.clear();
+    d.state->pending.clear();
+}
+
+template<typename Policy>
+void
+SubtreeCache<Policy>::process(const std::shared_ptr<State>& state, const std::function<void()>& notify,
+                              bool progressive)
+{
+    QMutexLocker updateLocker(&state->updateMutex);
+    while (true) {
+        UsdStageRefPtr stage;
+        QReadWriteLock* lock = nullptr;
+        Policy policy;
+        bool ready = false;
+        quint64 generation = 0;
+        QList<SdfPath> paths;
+        {
+            QMutexLocker locker(&state->mutex);
+            if (!state->stage || !state->enabled || (state->ready && state->pending.isEmpty())) {
+                state->running = false;
+                return;
+            }
+            stage = state->stage;
+            lock = state->lock;
+            policy = state->policy;
+            ready = state->ready;
+            generation = state->generation;
+            paths.swap(state->pending);
+        }
+
+        // a build started after the queued paths were resynced already includes them
+        if (!ready || paths.contains(SdfPath::AbsoluteRootPath())) {
+            {
+                QMutexLocker locker(&state->mutex);
+                if (generation == state->generation) {
+                    state->entries.clear();
+                    state->computed.clear();
+                    state->ready = false;
+                }
+            }
+            build(state, stage, lock, policy, generation, notify, progressive);
+        }
+        else {
+            update(state, stage, lock, policy, paths, generation);
+        }
+
+        if (notify)
+            notify();
+    }
+}
+
+template<typename Policy>
+void
+SubtreeCache<Policy>::build(const std::shared_ptr<State>& state, UsdStageRefPtr stage, QReadWriteLock* lock,
+                            const Policy& policy, quint64 generation, const std::function<void()>& notify,
+                            bool progressive)
+{
+    READ_LOCKER(locker, lock, "stageLock");
+
+    // split the upper levels into independent subtrees, one task each
+    std::vector<UsdPrim> upper;
+    std::vector<UsdPrim> frontier = { stage->GetPseudoRoot() };
+    for (int level = 0; level < 4 && !frontier.empty() && frontier.size() < 256; ++level) {
+        std::vector<UsdPrim> next;
+        for (const UsdPrim& prim : frontier) {
+            const UsdPrim::SiblingRange children = prim.GetAllChildren();
+            if (!policy.isExpanded(prim) || children.empty()) {
+                next.push_back(prim);
+                continue;
+            }
+            upper.push_back(prim);
+            for (const UsdPrim& child : children)
+                next.push_back(child);
+        }
+        frontier.swap(next);
+    }
+
+    // finished subtrees are published right away, progress is notified at most every 100 ms
+    QElapsedTimer timer;
+    timer.start();
+    WorkParallelForN(frontier.size(), [&](size_t begin, size_t end) {
+        Policy taskPolicy = policy;
+        for (size_t i = begin; i < end; ++i) {
+            Entries entries;
+            computeSubtree(taskPolicy, frontier[i], entries, nullptr);
+
+            QMutexLocker stateLocker(&state->mutex);
+            if (generation != state->generation)
+                return;
+            state->entries.insert(entries);
+            state->computed.insert(frontier[i].GetPath());
+            if (progressive && notify && timer.elapsed() > 100) {
+                timer.restart();
+                notify();
+            }
+        }
+    });
+
+    // children before parents, so each fold sees complete child entries
+    Policy foldPolicy = policy;
+    QMutexLocker stateLocker(&state->mutex);
+    if (generation != state->generation)
+        return;
+
+    for (auto it = upper.rbegin(); it != upper.rend(); ++it) {
+        const Entry entry = fold(foldPolicy, *it, state->entries);
+        if (!Policy::isEmpty(entry))
+            state->entries.insert(it->GetPath(), entry);
+    }
+    state->computed.clear();
+    state->ready = true;
+}
+
+template<typename Policy>
+void
+SubtreeCache<Policy>::update(const std::shared_ptr<State>& state, UsdStageRefPtr stage, QReadWriteLock* lock,
+                             const Policy& policy, const QList<SdfPath>& paths, quint64 generation)
+{
+    READ_LOCKER(locker, lock, "stageLock");
+    Policy updatePolicy = policy;
+    for (const SdfPath& path : path::topLevelPaths(paths)) {
+        Entries entries;
+        std::vector<SdfPath> empty;
+        const UsdPrim prim = stage->GetPrimAtPath(path);
+        if (prim)
+            computeSubtree(updatePolicy, prim, entries, &empty);
+
+        QMutexLocker stateLocker(&state->mutex);
+        if (generation != state->generation)
+            return;
+
+        // entries of removed descendants are left behind, they are never looked up for live prims
+        state->entries.remove(path);
+        for (const SdfPath& emptyPath : empty)
+            state->entries.remove(emptyPath);
+        state->entries.insert(entries);
+
+        for (SdfPath parent = path.GetParentPath(); !parent.IsEmpty(); parent = parent.GetParentPath()) {
+            const UsdPrim parentPrim = stage->GetPrimAtPath(parent);
+            if (!parentPrim)
+                continue;
+
+            const Entry entry = fold(updatePolicy, parentPrim, state->entries);
+            if (!Policy::isEmpty(entry))
+                state->entries.insert(parent, entry);
+            else
+                state->entries.remove(parent);
+        }
+    }
+}
+
+template<typename Policy>
+typename SubtreeCache<Policy>::Entry
+SubtreeCache<Policy>::computeSubtree(Policy& policy, const UsdPrim& prim, Entries& entries,
+                                     std::vector<SdfPath>* empty)
+{
+    Entry entry = policy.compute(prim);
+    if (policy.isExpanded(prim)) {
+        for (const UsdPrim& child : prim.GetAllChildren())
+            Policy::add(entry, computeSubtree(policy, child, entries, empty));
+    }
+
+    if (!Policy::isEmpty(entry))
+        entries.insert(prim.GetPath(), entry);
+    else if (empty)
+        empty->push_back(prim.GetPath());
+    return entry;
+}
+
+template<typename Policy>
+typename SubtreeCache<Policy>::Entry
+SubtreeCache<Policy>::fold(Policy& policy, const UsdPrim& prim, const Entries& entries)
+{
+    Entry entry = policy.compute(prim);
+    if (policy.isExpanded(prim)) {
+        for (const UsdPrim& child : prim.GetAllChildren())
+            Policy::add(entry, lookup(entries, child.GetPath()));
+    }
+    return entry;
+}
+
+template<typename Policy>
+typename SubtreeCache<Policy>::Entry
+SubtreeCache<Policy>::lookup(const Entries& entries, const SdfPath& path)
+{
+    auto it = entries.constFind(path);
+    if (it != entries.cend())
+        return it.value();
+    return Policy::empty(path);
+}
+
+}  // namespace usdviewer
@@ -12,6 +12,7 @@
 #include <QPainter>
 #include <QPointer>
 #include <QStyledItemDelegate>
+#include <algorithm>
 
 namespace usdviewer {
 
@@ -159,7 +160,7 @@ public:
                                (opt.state & QStyle::State_Enabled) ? QIcon::Normal : QIcon::Disabled);
             }
 
-            if (index.column() == 0) {
+            if (index.column() == 0 || !opt.text.isEmpty()) {
                 painter->setPen(opt.palette.color(QPalette::Text));
                 painter->setFont(opt.font);
                 painter->drawText(l.textRect, opt.displayAlignment | Qt::AlignVCenter,
@@ -333,6 +334,38 @@ TreeWidget::itemViewOption(const QModelIndex& index) const
     return opt;
 }
 
+void
+TreeWidget::selectItems(const QList<QTreeWidgetItem*>& items, QItemSelectionModel::SelectionFlags command)
+{
+    if (items.isEmpty())
+        return;
+
+    // sort by parent then row so sibling runs become one range each
+    QList<QPair<QModelIndex, QModelIndex>> indexes;
+    indexes.reserve(items.size());
+    for (QTreeWidgetItem* item : items) {
+        const QModelIndex index = indexFromItem(item);
+        if (index.isValid())
+            indexes.append({ index.parent(), index });
+    }
+    std::sort(indexes.begin(), indexes.end(), [](const auto& a, const auto& b) {
+        if (a.first != b.first)
+            return a.first < b.first;
+        return a.second.row() < b.second.row();
+    });
+
+    QItemSelection selection;
+    for (qsizetype i = 0; i < indexes.size();) {
+        qsizetype last = i;
+        while (last + 1 < indexes.size() && indexes[last + 1].first == indexes[i].first
+               && indexes[last + 1].second.row() == indexes[last].second.row() + 1)
+            ++last;
+        selection.append(QItemSelectionRange(indexes[i].second, indexes[last].second));
+        i = last + 1;
+    }
+    selectionModel()->select(selection, command | QItemSelectionModel::Rows);
+}
+
 bool
 TreeWidget::viewportEvent(QEvent* event)
 {
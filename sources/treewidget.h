@@ -40,6 +40,16 @@ public:
      */
     QStyleOptionViewItem itemViewOption(const QModelIndex& index) const;
 
+    /**
+     * @brief Selects or deselects items with a single selection change.
+     *
+     * Consecutive sibling rows are merged into one selection range.
+     *
+     * @param items Items to update.
+     * @param command Selection command, such as Select or Deselect.
+     */
+    void selectItems(const QList<QTreeWidgetItem*>& items, QItemSelectionModel::SelectionFlags command);
+
 protected:
     /**
      * @brief Handles viewport-level events.
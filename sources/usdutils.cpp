@@ -12,7 +12,10 @@
 #include <pxr/usd/usd/variantSets.h>
 #include <pxr/usd/usdGeom/bboxCache.h>
 #include <pxr/usd/usdGeom/imageable.h>
+#include <pxr/usd/usdGeom/mesh.h>
+#include <pxr/usd/usdGeom/primvarsAPI.h>
 #include <pxr/usd/usdGeom/tokens.h>
+#include <pxr/usd/usdGeom/xform.h>
 #include <stack>
 
 namespace usdviewer {
@@ -714,5 +717,67 @@ namespace stage {
         return out;
     }
 
+    void accumulateStatistics(const UsdPrim& prim, Statistics& statistics)
+    {
+        if (!prim.IsActive() || !prim.IsLoaded() || !prim.IsDefined() || prim.IsAbstract())
+            return;
+
+        statistics.prims++;
+
+        if (prim.IsA<UsdGeomXform>())
+            statistics.xforms++;
+
+        if (prim.IsA<UsdGeomMesh>()) {
+            statistics.meshes++;
+            UsdGeomMesh mesh(prim);
+
+            // the whole array is read to size it, there is no cheaper count through the public api
+            auto arraySize = [](const UsdAttribute& attr) -> size_t {
+                VtValue value;
+                if (!attr || !attr.Get(&value))
+                    return 0;
+                return value.IsArrayValued() ? value.GetArraySize() : 0;
+            };
+
+            statistics.vertices += arraySize(mesh.GetPointsAttr());
+            statistics.faces += arraySize(mesh.GetFaceVertexCountsAttr());
+
+            UsdGeomPrimvar normalsPrimvar = UsdGeomPrimvarsAPI(prim).GetPrimvar(UsdGeomTokens->normals);
+            if (normalsPrimvar && normalsPrimvar.HasValue())
+                statistics.normals += arraySize(normalsPrimvar.GetAttr());
+            else
+                statistics.normals += arraySize(mesh.GetNormalsAttr());
+        }
+
+        if (prim.HasPayload())
+            statistics.payloads++;
+
+        if (prim.IsInstanceable())
+            statistics.instances++;
+    }
+
+    Statistics statistics(UsdStageRefPtr stage, const QList<SdfPath>& paths)
+    {
+        Statistics result;
+        if (!stage)
+            return result;
+
+        if (paths.isEmpty()) {
+            for (const UsdPrim& prim : stage->Traverse())
+                accumulateStatistics(prim, result);
+            return result;
+        }
+
+        for (const SdfPath& path : path::topLevelPaths(paths)) {
+            const UsdPrim root = stage->GetPrimAtPath(path);
+            if (!root)
+                continue;
+
+            for (const UsdPrim& prim : UsdPrimRange(root))
+                accumulateStatistics(prim, result);
+        }
+        return result;
+    }
+
 }  // namespace stage
 }  // namespace usdviewer
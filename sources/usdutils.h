@@ -468,5 +468,41 @@ namespace stage {
      */
     UsdStageLoadRules remapLoadRules(const UsdStageLoadRules& rules, const SdfPath& oldPath, const SdfPath& newPath);
 
+    /**
+     * @struct Statistics
+     * @brief Scene statistics for active, loaded prims.
+     */
+    struct Statistics {
+        size_t prims = 0;      ///< Active, loaded prims.
+        size_t meshes = 0;     ///< UsdGeomMesh prims.
+        size_t xforms = 0;     ///< UsdGeomXform prims.
+        size_t payloads = 0;   ///< Prims with payloads.
+        size_t instances = 0;  ///< Instanceable prims.
+        size_t vertices = 0;   ///< Mesh points.
+        size_t normals = 0;    ///< Mesh normals, from primvars or the normals attribute.
+        size_t faces = 0;      ///< Mesh faces.
+    };
+
+    /**
+     * @brief Adds the statistics of a single prim.
+     *
+     * Inactive, unloaded, class and over prims are ignored, matching
+     * the default traversal predicate.
+     *
+     * @param prim Prim to accumulate.
+     * @param statistics Statistics to update.
+     */
+    void accumulateStatistics(const UsdPrim& prim, Statistics& statistics);
+
+    /**
+     * @brief Collects statistics for the stage or for prim hierarchies.
+     *
+     * @param stage USD stage to query.
+     * @param paths Root prim paths, empty for the whole stage.
+     *
+     * @return Statistics of the traversed prims.
+     */
+    Statistics statistics(UsdStageRefPtr stage, const QList<SdfPath>& paths = QList<SdfPath>());
+
 }  // namespace stage
 }  // namespace usdviewer
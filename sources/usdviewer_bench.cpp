@@ -0,0 +1,306 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright (c) 2025 - present Mikael Sundell
+// https://github.com/mikaelsundell/usdviewer
+
+#include "application.h"
+#include "qtutils.h"
+#include "session.h"
+#include "stagecache.h"
+#include "stagegenerator.h"
+#include "tracelocks.h"
+#include "usdutils.h"
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <pxr/usd/sdf/changeBlock.h>
+#include <pxr/usd/usd/primRange.h>
+#include <algorithm>
+#include <functional>
+
+namespace usdviewer {
+namespace bench {
+    struct Options {
+        QList<int> sizes = { 1000, 10000, 100000 };
+        int iterations = 3;
+        QString output;
+    };
+
+    struct Timing {
+        double min = 0.0;
+        double mean = 0.0;
+        double max = 0.0;
+    };
+
+    Timing measure(int iterations, const std::function<void()>& function)
+    {
+        return measure(iterations, std::function<void()>(), function);
+    }
+
+    Timing measure(int iterations, const std::function<void()>& setup, const std::function<void()>& function)
+    {
+        Timing timing;
+        double total = 0.0;
+        for (int i = 0; i < iterations; ++i) {
+            // setup runs untimed before each iteration
+            if (setup)
+                setup();
+
+            QElapsedTimer timer;
+            timer.start();
+            function();
+            const double msecs = timer.nsecsElapsed() / 1.0e6;
+            timing.min = i == 0 ? msecs : std::min(timing.min, msecs);
+            timing.max = std::max(timing.max, msecs);
+            total += msecs;
+        }
+        timing.mean = total / std::max(iterations, 1);
+        return timing;
+    }
+
+    QJsonObject toJson(const Timing& timing)
+    {
+        QJsonObject object;
+        object["min"] = timing.min;
+        object["mean"] = timing.mean;
+        object["max"] = timing.max;
+        return object;
+    }
+
+    bool writeState(const QString& filename, const QList<SdfPath>& paths)
+    {
+        QJsonArray payloads;
+        for (const SdfPath& path : paths)
+            payloads.append(StringToQString(path.GetString()));
+
+        QJsonObject root;
+        root["version"] = 1;
+        root["loadedPayloads"] = payloads;
+
+        QFile file(filename);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return false;
+        return file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) != -1;
+    }
+
+    QList<SdfPath> collectPaths(UsdStageRefPtr stage, QList<SdfPath>& payloadPaths)
+    {
+        QList<SdfPath> paths;
+        for (const UsdPrim& prim : stage->Traverse()) {
+            paths.append(prim.GetPath());
+            if (prim.HasAuthoredPayloads())
+                payloadPaths.append(prim.GetPath());
+        }
+        return paths;
+    }
+
+    QJsonObject run(int size, const Options& options, const QString& directory)
+    {
+        QJsonObject result;
+        result["size"] = size;
+
+        // every leaf behind a payload, so payload helpers see the whole stage
+        StageGenerator::Options generatorOptions;
+        generatorOptions.prims = size;
+        generatorOptions.depth = 2;
+        generatorOptions.fanOut = 100;
+        generatorOptions.payloadDensity = 1.0;
+        StageGenerator generator(generatorOptions);
+
+        const QString filename = QDir(directory).filePath(QString("stage%1.usdc").arg(size));
+        QElapsedTimer timer;
+        timer.start();
+        if (!generator.generate(filename)) {
+            result["error"] = generator.error();
+            return result;
+        }
+        result["generateSeconds"] = timer.elapsed() / 1000.0;
+
+        QList<SdfPath> payloadPaths;
+        {
+            UsdStageRefPtr stage = UsdStage::Open(QStringToString(filename), UsdStage::LoadNone);
+            collectPaths(stage, payloadPaths);
+        }
+
+        // every tenth payload, written as a session state file that is not the stage's companion,
+        // so plain loads do not restore it
+        QList<SdfPath> statePaths;
+        for (int i = 0; i < payloadPaths.size(); i += 10)
+            statePaths.append(payloadPaths[i]);
+        const QString stateFilename = QDir(directory).filePath(QString("state%1.session").arg(size));
+        writeState(stateFilename, statePaths);
+
+        QJsonObject benchmarks;
+        benchmarks["loadFromFile"] = toJson(measure(options.iterations, [&]() {
+            session()->stageCache()->clear();
+            session()->loadFromFile(filename, Session::LoadPolicy::All);
+        }));
+        benchmarks["loadFromFileNone"] = toJson(measure(options.iterations, [&]() {
+            session()->stageCache()->clear();
+            session()->loadFromFile(filename, Session::LoadPolicy::None);
+        }));
+
+        // open with the state as load rules, payloads are composed with the stage
+        Session::LoadOptions stateOptions;
+        stateOptions.loadRules = stateFilename;
+        benchmarks["loadRules"] = toJson(measure(options.iterations, [&]() {
+            session()->stageCache()->clear();
+            session()->loadFromFile(filename, stateOptions, Session::LoadPolicy::None);
+        }));
+
+        // restore the state on an already open stage, the open is not timed
+        benchmarks["restoreState"] = toJson(measure(
+            options.iterations,
+            [&]() {
+                session()->stageCache()->clear();
+                session()->loadFromFile(filename, Session::LoadPolicy::None);
+            },
+            [&]() { session()->mergeFromFile(stateFilename); }));
+
+        // leave a fully loaded stage for the notice and usdutils benchmarks
+        session()->stageCache()->clear();
+        session()->loadFromFile(filename, Session::LoadPolicy::All);
+
+        QList<SdfPath> primPaths;
+        QList<SdfPath> selectionPaths;
+        {
+            READ_LOCKER(locker, session()->stageLock(), "stageLock");
+            QList<SdfPath> loadedPayloadPaths;
+            primPaths = collectPaths(session()->stageUnsafe(), loadedPayloadPaths);
+        }
+        for (const SdfPath& path : payloadPaths) {
+            selectionPaths.append(path);
+            selectionPaths.append(path.AppendChild(TfToken("Mesh")));
+        }
+        result["prims"] = primPaths.size();
+
+        int value = 0;
+        benchmarks["noticeDispatch"] = toJson(measure(options.iterations, [&]() {
+            {
+                WRITE_LOCKER(locker, session()->stageLock(), "stageLock");
+                UsdStageRefPtr stage = session()->stageUnsafe();
+                SdfChangeBlock changeBlock;
+                for (const SdfPath& path : payloadPaths) {
+                    UsdPrim prim = stage->GetPrimAtPath(path);
+                    prim.SetCustomDataByKey(TfToken("bench"), VtValue(value));
+                }
+            }
+            session()->flushPrimsUpdates();
+            ++value;
+        }));
+
+        const Session::NoticeStatistics statistics = session()->noticeStatistics();
+        QJsonObject notices;
+        notices["received"] = qint64(statistics.received);
+        notices["merged"] = qint64(statistics.merged);
+        notices["delivered"] = qint64(statistics.delivered);
+        result["notices"] = notices;
+
+        benchmarks["topLevelPaths"] = toJson(
+            measure(options.iterations, [&]() { path::topLevelPaths(selectionPaths); }));
+        {
+            READ_LOCKER(locker, session()->stageLock(), "stageLock");
+            UsdStageRefPtr stage = session()->stageUnsafe();
+            const QList<SdfPath> rootPaths = { SdfPath("/World") };
+            benchmarks["selectionPayloadPaths"] = toJson(
+                measure(options.iterations, [&]() { path::selectionPayloadPaths(stage, selectionPaths); }));
+            benchmarks["descendantsPayloadPaths"] = toJson(
+                measure(options.iterations, [&]() { path::descendantsPayloadPaths(stage, rootPaths); }));
+            benchmarks["boundingBox"] = toJson(
+                measure(options.iterations, [&]() { stage::boundingBox(stage, rootPaths); }));
+        }
+        result["benchmarks"] = benchmarks;
+
+        session()->close();
+        return result;
+    }
+
+    bool parse(const QStringList& arguments, Options& options, QTextStream& err)
+    {
+        for (int i = 1; i < arguments.size(); ++i) {
+            const QString& argument = arguments[i];
+            const bool hasValue = i + 1 < arguments.size();
+            if (argument == "--sizes" && hasValue) {
+                options.sizes.clear();
+                for (const QString& value :
+                     arguments[++i].split(QRegularExpression("[,\\s]+"), Qt::SkipEmptyParts)) {
+                    bool ok = false;
+                    const int size = value.toInt(&ok);
+                    if (!ok || size <= 0) {
+                        err << "usdviewer_bench: invalid size: " << value << Qt::endl;
+                        return false;
+                    }
+                    options.sizes.append(size);
+                }
+            }
+            else if (argument == "--iterations" && hasValue) {
+                options.iterations = std::max(arguments[++i].toInt(), 1);
+            }
+            else if (argument == "--output" && hasValue) {
+                options.output = arguments[++i];
+            }
+            else {
+                err << "usage: usdviewer_bench [--sizes <n,n,...>] [--iterations <n>] [--output <file.json>]"
+                    << Qt::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+}  // namespace bench
+}  // namespace usdviewer
+
+int
+main(int argc, char* argv[])
+{
+    using namespace usdviewer;
+
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    Application app(argc, argv, Application::Mode::Batch);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    bench::Options options;
+    if (!bench::parse(QCoreApplication::arguments(), options, err))
+        return 2;
+
+    QTemporaryDir directory;
+    if (!directory.isValid()) {
+        err << "usdviewer_bench: failed to create temporary directory" << Qt::endl;
+        return 1;
+    }
+
+    QJsonArray results;
+    for (int size : options.sizes) {
+        err << "usdviewer_bench: " << size << " prims" << Qt::endl;
+        results.append(bench::run(size, options, directory.path()));
+    }
+
+    QJsonObject root;
+    root["version"] = PROJECT_VERSION;
+    root["config"] = PROJECT_CONFIG;
+    root["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["platform"] = QSysInfo::prettyProductName();
+    root["iterations"] = options.iterations;
+    root["results"] = results;
+
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    if (options.output.isEmpty()) {
+        out << QString::fromUtf8(json);
+        return 0;
+    }
+
+    QFile file(options.output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) == -1) {
+        err << "usdviewer_bench: failed to write " << options.output << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -13,6 +13,7 @@ public:
     struct Data {
         QReadWriteLock* stageLock = nullptr;
         CommandStack* commandStack = nullptr;
+        StatisticsCache* statisticsCache = nullptr;
     };
     Data d;
 };
@@ -48,6 +49,18 @@ ViewContext::commandStack() const
     return p->d.commandStack;
 }
 
+void
+ViewContext::setStatisticsCache(StatisticsCache* statisticsCache)
+{
+    p->d.statisticsCache = statisticsCache;
+}
+
+StatisticsCache*
+ViewContext::statisticsCache() const
+{
+    return p->d.statisticsCache;
+}
+
 bool
 ViewContext::hasStageLock() const
 {
@@ -12,6 +12,7 @@ namespace usdviewer {
 
 class Command;
 class CommandStack;
+class StatisticsCache;
 class ViewContextPrivate;
 
 /**
@@ -60,6 +61,18 @@ public:
      */
     CommandStack* commandStack() const;
 
+    /**
+     * @brief Sets the subtree statistics shared between widgets.
+     *
+     * The cache is owned externally, typically by the active session.
+     */
+    void setStatisticsCache(StatisticsCache* statisticsCache);
+
+    /**
+     * @brief Returns the shared subtree statistics.
+     */
+    StatisticsCache* statisticsCache() const;
+
     /**
      * @brief Returns true if the context can provide stage locking.
      */
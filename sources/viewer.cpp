@@ -19,6 +19,7 @@
 #include "session.h"
 #include "settings.h"
 #include "signalguard.h"
+#include "stagecache.h"
 #include "style.h"
 #include "tracelocks.h"
 #include "usdutils.h"
@@ -34,6 +35,8 @@
 #include <QMimeData>
 #include <QObject>
 #include <QPointer>
+#include <QRegularExpression>
+#include <QSet>
 #include <QSettings>
 #include <QStatusBar>
 #include <QTimer>
@@ -53,7 +56,7 @@ public:
     void initDocks();
     void initRecentFiles();
     void initSettings();
-    bool loadFile(const QString& fileName);
+    bool loadFile(const QString& fileName, const Session::LoadOptions& options = Session::LoadOptions());
     bool mergeFile(const QString& fileName);
     DockWidget* createDock(const QString& objectName, const QString& title, QWidget* view, Qt::DockWidgetArea area);
     void updateDockAction(QAction* action, bool checked);
@@ -76,6 +79,7 @@ public Q_SLOTS:
     void saveAs();
     void saveCopy();
     void reload();
+    void reloadChanged();
     void close();
     void undo();
     void redo();
@@ -84,6 +88,8 @@ public Q_SLOTS:
     void backgroundColor();
     void exportAll();
     void exportSelected();
+    void exportSelectedRoots();
+    void exportFinished(int id, const QString& filename, bool exported, bool cancelled);
     void exportImage();
     void saveSettings();
     void exit();
@@ -129,6 +135,8 @@ public Q_SLOTS:
     void maskChanged(const QList<SdfPath>& paths);
     void primsChanged(const NoticeBatch& batch);
     void stageChanged(UsdStageRefPtr stage, Session::LoadPolicy policy, Session::StageStatus status);
+    void loadFinished(const QString& filename, bool loaded, bool cancelled);
+    void mergeFinished(const QString& filename, bool merged, bool cancelled);
     void stageUpChanged(Session::StageUp stageUp);
     void notifyStatusChanged(Session::Notify::Status status, const QString& message);
 
@@ -149,6 +157,9 @@ public:
         QStringList arguments;
         QStringList extensions;
         QStringList recentFiles;
+        QElapsedTimer loadTimer;
+        QElapsedTimer mergeTimer;
+        QHash<int, QElapsedTimer> exportTimers;
         QColor backgroundColor;
         Qt::DockWidgetArea outlinerArea;
         Qt::DockWidgetArea progressArea;
@@ -295,6 +306,8 @@ ViewerPrivate::init()
         actions->addAction(d.ui->policyAll);
         actions->addAction(d.ui->policyPayload);
     }
+    connect(d.ui->policyStream, &QAction::toggled, this,
+            [=](bool checked) { renderView()->setPayloadStreamingEnabled(checked); });
     connect(d.ui->fileNew, &QAction::triggered, this, &ViewerPrivate::newFile);
     connect(d.ui->fileOpen, &QAction::triggered, this, &ViewerPrivate::open);
     connect(d.ui->fileMerge, &QAction::triggered, this, &ViewerPrivate::merge);
@@ -302,9 +315,13 @@ ViewerPrivate::init()
     connect(d.ui->fileSaveAs, &QAction::triggered, this, &ViewerPrivate::saveAs);
     connect(d.ui->fileSaveCopy, &QAction::triggered, this, &ViewerPrivate::saveCopy);
     connect(d.ui->fileReload, &QAction::triggered, this, &ViewerPrivate::reload);
+    connect(d.ui->fileReloadChanged, &QAction::triggered, this, &ViewerPrivate::reloadChanged);
+    connect(d.ui->fileAutoRefresh, &QAction::toggled, this,
+            [=](bool checked) { session()->setAutoRefresh(checked); });
     connect(d.ui->fileClose, &QAction::triggered, this, &ViewerPrivate::close);
     connect(d.ui->fileExportAll, &QAction::triggered, this, &ViewerPrivate::exportAll);
     connect(d.ui->fileExportSelected, &QAction::triggered, this, &ViewerPrivate::exportSelected);
+    connect(d.ui->fileExportSelectedRoots, &QAction::triggered, this, &ViewerPrivate::exportSelectedRoots);
     connect(d.ui->fileExportImage, &QAction::triggered, this, &ViewerPrivate::exportImage);
     connect(d.ui->fileSaveSettings, &QAction::triggered, this, &ViewerPrivate::saveSettings);
     connect(d.ui->fileExit, &QAction::triggered, this, &ViewerPrivate::exit);
@@ -373,6 +390,9 @@ ViewerPrivate::init()
     connect(session(), &Session::maskChanged, this, &ViewerPrivate::maskChanged);
     connect(session(), &Session::primsChanged, this, &ViewerPrivate::primsChanged);
     connect(session(), &Session::stageChanged, this, &ViewerPrivate::stageChanged);
+    connect(session(), &Session::loadFinished, this, &ViewerPrivate::loadFinished);
+    connect(session(), &Session::mergeFinished, this, &ViewerPrivate::mergeFinished);
+    connect(session(), &Session::exportFinished, this, &ViewerPrivate::exportFinished);
     connect(session(), &Session::stageUpChanged, this, &ViewerPrivate::stageUpChanged);
     connect(session(), &Session::notifyStatusChanged, this, &ViewerPrivate::notifyStatusChanged);
     connect(session()->selectionList(), &SelectionList::selectionChanged, this, &ViewerPrivate::selectionChanged);
@@ -457,6 +477,14 @@ ViewerPrivate::initSettings()
     d.ui->hudCameraAxis->setChecked(cameraAxis);
     renderView()->setCameraAxisEnabled(cameraAxis);
 
+    bool payloadStreaming = settings()->value("payloadStreaming", false).toBool();
+    d.ui->policyStream->setChecked(payloadStreaming);
+    renderView()->setPayloadStreamingEnabled(payloadStreaming);
+
+    bool autoRefresh = settings()->value("autoRefresh", false).toBool();
+    d.ui->fileAutoRefresh->setChecked(autoRefresh);
+    session()->setAutoRefresh(autoRefresh);
+
     QString theme = settings()->value("theme", "dark").toString();
     if (theme == "dark") {
         dark();
@@ -472,7 +500,7 @@ ViewerPrivate::initSettings()
 }
 
 bool
-ViewerPrivate::loadFile(const QString& fileName)
+ViewerPrivate::loadFile(const QString& fileName, const Session::LoadOptions& options)
 {
     QFileInfo fileInfo(fileName);
     if (!d.extensions.contains(fileInfo.suffix().toLower())) {
@@ -481,22 +509,15 @@ ViewerPrivate::loadFile(const QString& fileName)
         return false;
     }
 
-    QElapsedTimer timer;
-    timer.start();
+    d.loadTimer.start();
 
-    if (!session()->loadFromFile(fileName, d.loadPolicy)) {
+    if (!session()->loadFromFile(fileName, options, d.loadPolicy, Session::LoadMode::Background)) {
         session()->notifyStatus(Session::Notify::Status::Error, QString("Failed to load file: %1").arg(fileName));
         return false;
     }
 
-    const double elapsedSec = timer.elapsed() / 1000.0;
-
     settings()->setValue("openDir", fileInfo.absolutePath());
-    session()->notifyStatus(Session::Notify::Status::Info,
-                            QString("Loaded %1 in %2 seconds").arg(fileName).arg(QString::number(elapsedSec, 'f', 2)));
-    updateWindowTitle();
-    updateRecentFiles(QFileInfo(fileName).absoluteFilePath());
-    clearChanges();
+    session()->notifyStatus(Session::Notify::Status::Info, QString("Loading %1 ...").arg(fileName));
     return true;
 }
 
@@ -511,20 +532,14 @@ ViewerPrivate::mergeFile(const QString& fileName)
         return false;
     }
 
-    QElapsedTimer timer;
-    timer.start();
+    d.mergeTimer.start();
 
-    if (!session()->mergeFromFile(fileName)) {
+    if (!session()->mergeFromFile(fileName, Session::LoadMode::Background)) {
         session()->notifyStatus(Session::Notify::Status::Error, QString("Failed to merge file: %1").arg(fileName));
         return false;
     }
 
-    const double elapsedSec = timer.elapsed() / 1000.0;
-
     settings()->setValue("openDir", fileInfo.absolutePath());
-    session()->notifyStatus(Session::Notify::Status::Info,
-                            QString("Merge %1 in %2 seconds").arg(fileName).arg(QString::number(elapsedSec, 'f', 2)));
-    clearChanges();
     return true;
 }
 
@@ -603,12 +618,14 @@ void
 ViewerPrivate::enable(bool enable)
 {
     QList<QAction*> actions = { d.ui->fileReload,
+                                d.ui->fileReloadChanged,
                                 d.ui->fileClose,
                                 d.ui->fileSave,
                                 d.ui->fileSaveAs,
                                 d.ui->fileSaveCopy,
                                 d.ui->fileExportAll,
                                 d.ui->fileExportSelected,
+                                d.ui->fileExportSelectedRoots,
                                 d.ui->fileExportImage,
                                 d.ui->editCopyImage,
                                 d.ui->editDeleteSelected,
@@ -822,6 +839,36 @@ ViewerPrivate::reload()
     clearChanges();
 }
 
+void
+ViewerPrivate::reloadChanged()
+{
+    if (!session()->isLoaded())
+        return;
+
+    const QStringList layers = session()->changedLayers();
+    if (layers.isEmpty()) {
+        session()->notifyStatus(Session::Notify::Status::Info, "No changed layers to reload");
+        return;
+    }
+    if (!saveChanges())
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!session()->reload(Session::ReloadMode::Changed)) {
+        session()->notifyStatus(Session::Notify::Status::Error, "Failed to reload changed layers");
+        return;
+    }
+
+    const double elapsedSec = timer.elapsed() / 1000.0;
+    session()->commandStack()->clear();
+    session()->notifyStatus(Session::Notify::Status::Info, QString("Reloaded %1 layers in %2 seconds")
+                                                               .arg(layers.size())
+                                                               .arg(QString::number(elapsedSec, 'f', 2)));
+    clearChanges();
+}
+
 void
 ViewerPrivate::close()
 {
@@ -920,19 +967,14 @@ ViewerPrivate::exportAll()
     if (QFileInfo(fileName).suffix().isEmpty())
         fileName += ".usd";
 
-    QElapsedTimer timer;
-    timer.start();
-
-    if (session()->flattenToFile(fileName)) {
-        const double elapsedSec = timer.elapsed() / 1000.0;
-        settings()->setValue("exportAllDir", QFileInfo(fileName).absolutePath());
-        session()->notifyStatus(
-            Session::Notify::Status::Info,
-            QString("Exported all to %1 in %2 seconds").arg(fileName).arg(QString::number(elapsedSec, 'f', 2)));
-    }
-    else {
+    const int id = session()->exportToFile(fileName);
+    if (!id) {
         session()->notifyStatus(Session::Notify::Status::Error, QString("Failed to export all: %1").arg(fileName));
+        return;
     }
+
+    d.exportTimers[id].start();
+    settings()->setValue("exportAllDir", QFileInfo(fileName).absolutePath());
 }
 
 void
@@ -965,19 +1007,74 @@ ViewerPrivate::exportSelected()
     if (QFileInfo(fileName).suffix().isEmpty())
         fileName += ".usd";
 
-    QElapsedTimer timer;
-    timer.start();
+    const QList<SdfPath> paths = session()->selectionList()->paths();
+    const int id = paths.isEmpty() ? 0 : session()->exportToFile(fileName, paths);
+    if (!id) {
+        session()->notifyStatus(Session::Notify::Status::Error, QString("Failed to export selected: %1").arg(fileName));
+        return;
+    }
 
-    if (session()->flattenPathsToFile(session()->selectionList()->paths(), fileName)) {
-        const double elapsedSec = timer.elapsed() / 1000.0;
-        settings()->setValue("exportSelectedDir", QFileInfo(fileName).absolutePath());
-        session()->notifyStatus(
-            Session::Notify::Status::Info,
-            QString("Exported selected to %1 in %2 seconds").arg(fileName).arg(QString::number(elapsedSec, 'f', 2)));
+    d.exportTimers[id].start();
+    settings()->setValue("exportSelectedDir", QFileInfo(fileName).absolutePath());
+}
+
+void
+ViewerPrivate::exportSelectedRoots()
+{
+    const QList<SdfPath> roots = path::topLevelPaths(session()->selectionList()->paths());
+    if (roots.isEmpty()) {
+        session()->notifyStatus(Session::Notify::Status::Warning, "No prims selected to export");
+        return;
     }
-    else {
-        session()->notifyStatus(Session::Notify::Status::Error, QString("Failed to export selected: %1").arg(fileName));
+
+    QString exportDir = settings()->value("exportSelectedDir", QDir::homePath()).toString();
+    exportDir = QFileDialog::getExistingDirectory(d.viewer.data(), "Export Selected Roots", exportDir);
+    if (exportDir.isEmpty())
+        return;
+
+    const QString suffix = QFileInfo(session()->filename()).suffix();
+    const QString extension = d.extensions.contains(suffix) ? suffix : QString("usd");
+    QHash<QString, int> nameCounts;
+    for (const SdfPath& root : roots)
+        nameCounts[StringToQString(root.GetName())]++;
+
+    // roots sharing a leaf name are named by their full path, exports never share a file
+    QSet<QString> usedNames;
+    for (const SdfPath& root : roots) {
+        QString name = StringToQString(root.GetName());
+        if (nameCounts.value(name) > 1)
+            name = StringToQString(root.GetString()).mid(1).replace('/', '_');
+
+        const QString baseName = name;
+        for (int index = 1; usedNames.contains(name); ++index)
+            name = QString("%1_%2").arg(baseName).arg(index);
+        usedNames.insert(name);
+
+        const QString fileName = QDir(exportDir).filePath(QString("%1.%2").arg(name, extension));
+        const int id = session()->exportToFile(fileName, { root });
+        if (id)
+            d.exportTimers[id].start();
+    }
+    settings()->setValue("exportSelectedDir", exportDir);
+}
+
+void
+ViewerPrivate::exportFinished(int id, const QString& filename, bool exported, bool cancelled)
+{
+    const QElapsedTimer timer = d.exportTimers.take(id);
+    if (cancelled) {
+        session()->notifyStatus(Session::Notify::Status::Warning, QString("Cancelled export: %1").arg(filename));
+        return;
+    }
+    if (!exported) {
+        session()->notifyStatus(Session::Notify::Status::Error, QString("Failed to export: %1").arg(filename));
+        return;
     }
+
+    const double elapsedSec = timer.isValid() ? timer.elapsed() / 1000.0 : 0.0;
+    session()->notifyStatus(Session::Notify::Status::Info, QString("Exported %1 in %2 seconds")
+                                                               .arg(filename)
+                                                               .arg(QString::number(elapsedSec, 'f', 2)));
 }
 
 void
@@ -1028,6 +1125,8 @@ ViewerPrivate::saveSettings()
     settings()->setValue("sceneTree", d.ui->hudSceneTree->isChecked());
     settings()->setValue("gpuPerformance", d.ui->hudGpuPerformance->isChecked());
     settings()->setValue("cameraAxis", d.ui->hudCameraAxis->isChecked());
+    settings()->setValue("payloadStreaming", d.ui->policyStream->isChecked());
+    settings()->setValue("autoRefresh", d.ui->fileAutoRefresh->isChecked());
 }
 
 void
@@ -1461,6 +1560,50 @@ ViewerPrivate::stageChanged(UsdStageRefPtr stage, Session::LoadPolicy policy, Se
         enable(true);
 }
 
+void
+ViewerPrivate::loadFinished(const QString& filename, bool loaded, bool cancelled)
+{
+    if (cancelled) {
+        session()->notifyStatus(Session::Notify::Status::Warning, QString("Cancelled loading file: %1").arg(filename));
+        return;
+    }
+    if (!loaded) {
+        session()->notifyStatus(Session::Notify::Status::Error, QString("Failed to load file: %1").arg(filename));
+        return;
+    }
+
+    const double elapsedSec = d.loadTimer.elapsed() / 1000.0;
+    const StageCache::Statistics cache = session()->stageCache()->statistics();
+    session()->notifyStatus(Session::Notify::Status::Info,
+                            QString("Loaded %1 in %2 seconds (stage cache: %3 hits, %4 misses, %5 evictions)")
+                                .arg(filename)
+                                .arg(QString::number(elapsedSec, 'f', 2))
+                                .arg(cache.hits)
+                                .arg(cache.misses)
+                                .arg(cache.evictions));
+    updateWindowTitle();
+    updateRecentFiles(QFileInfo(filename).absoluteFilePath());
+    clearChanges();
+}
+
+void
+ViewerPrivate::mergeFinished(const QString& filename, bool merged, bool cancelled)
+{
+    if (cancelled) {
+        session()->notifyStatus(Session::Notify::Status::Warning, QString("Cancelled merging file: %1").arg(filename));
+        return;
+    }
+    if (!merged) {
+        session()->notifyStatus(Session::Notify::Status::Error, QString("Failed to merge file: %1").arg(filename));
+        return;
+    }
+
+    const double elapsedSec = d.mergeTimer.elapsed() / 1000.0;
+    session()->notifyStatus(Session::Notify::Status::Info,
+                            QString("Merge %1 in %2 seconds").arg(filename).arg(QString::number(elapsedSec, 'f', 2)));
+    clearChanges();
+}
+
 void
 ViewerPrivate::stageUpChanged(Session::StageUp stageUp)
 {
@@ -1618,14 +1761,34 @@ Viewer::setArguments(const QStringList& arguments)
 {
     p->d.arguments = arguments;
 
+    QString filename;
+    Session::LoadOptions options;
     for (int i = 0; i < arguments.size(); ++i) {
-        if (arguments[i] == "--open" && i + 1 < arguments.size()) {
-            QString filename = arguments[i + 1];
-            if (!filename.isEmpty()) {
-                p->loadFile(filename);
-                return;
+        if (i + 1 >= arguments.size())
+            break;
+
+        if (arguments[i] == "--open") {
+            filename = arguments[++i];
+        }
+        else if (arguments[i] == "--mask") {
+            const QStringList values = arguments[++i].split(QRegularExpression("[,\\s]+"), Qt::SkipEmptyParts);
+            for (const QString& value : values) {
+                const SdfPath path(QStringToString(value));
+                if (path.IsAbsolutePath() && path.IsPrimPath())
+                    options.mask.append(path);
+                else
+                    session()->notifyStatus(Session::Notify::Status::Warning,
+                                            QString("Ignoring invalid mask path: %1").arg(value));
             }
         }
+        else if (arguments[i] == "--load-rules") {
+            options.loadRules = QFileInfo(arguments[++i]).absoluteFilePath();
+        }
+    }
+
+    if (!filename.isEmpty()) {
+        p->loadFile(filename, options);
+        return;
     }
 
     if (arguments.size() == 2) {
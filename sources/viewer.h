@@ -45,6 +45,10 @@ public:
      * Typically called during application startup to pass
      * file paths or configuration parameters to the viewer.
      *
+     * Supported options are "--open <file>", "--mask <paths>" with a
+     * comma separated list of prim paths used as population mask, and
+     * "--load-rules <file>" with a JSON load rules or ".session" file.
+     *
      * @param arguments Command line arguments.
      */
     void setArguments(const QStringList& arguments);